@@ -28,11 +28,13 @@
 #include <sys/types.h>
 #include <sys/mman.h>
 #endif
+#include <zlib.h>
 #include "config.h"
 #include "monitor/monitor.h"
 #include "sysemu/sysemu.h"
 #include "qemu/bitops.h"
 #include "qemu/bitmap.h"
+#include "qemu/atomic.h"
 #include "sysemu/arch_init.h"
 #include "audio/audio.h"
 #include "hw/i386/pc.h"
@@ -49,6 +51,10 @@
 #include "trace.h"
 #include "exec/cpu-all.h"
 #include "hw/acpi/acpi.h"
+#include "block/aio.h"
+#include "block/coroutine.h"
+#include "block/thread-pool.h"
+#include "qemu/main-loop.h"
 
 #ifdef DEBUG_ARCH_INIT
 #define DPRINTF(fmt, ...) \
@@ -119,6 +125,7 @@ static void check_guest_throttling(void);
 #define RAM_SAVE_FLAG_CONTINUE 0x20
 #define RAM_SAVE_FLAG_XBZRLE   0x40
 /* 0x80 is reserved in migration.h start with 0x100 next */
+#define RAM_SAVE_FLAG_CHUNK    0x100
 
 
 static struct defconfig_file {
@@ -166,6 +173,8 @@ static struct {
     uint8_t *decoded_buf;
     /* Cache for XBZRLE */
     PageCache *cache;
+    /* New cache size in pages, applied by the migration thread */
+    int64_t resize_pages;
 } XBZRLE = {
     .encoded_buf = NULL,
     .current_buf = NULL,
@@ -177,12 +186,26 @@ static struct {
 int64_t xbzrle_cache_resize(int64_t new_size)
 {
     if (XBZRLE.cache != NULL) {
-        return cache_resize(XBZRLE.cache, new_size / TARGET_PAGE_SIZE) *
-            TARGET_PAGE_SIZE;
+        /* The migration thread may be using the cache right now */
+        atomic_mb_set(&XBZRLE.resize_pages, new_size / TARGET_PAGE_SIZE);
+        return pow2floor(new_size / TARGET_PAGE_SIZE) * TARGET_PAGE_SIZE;
     }
     return pow2floor(new_size);
 }
 
+/* Resize the cache, keeping the pages that are cached */
+static void xbzrle_cache_apply_resize(QEMUFile *f)
+{
+    int64_t new_pages = atomic_xchg(&XBZRLE.resize_pages, 0);
+
+    if (XBZRLE.cache && new_pages > 0) {
+        /* Pages queued from the cache must reach the wire before
+           cache_resize() frees their buffers */
+        qemu_fflush(f);
+        cache_resize(XBZRLE.cache, new_pages);
+    }
+}
+
 /* accounting for migration statistics */
 typedef struct AccountingInfo {
     uint64_t dup_pages;
@@ -192,6 +215,7 @@ typedef struct AccountingInfo {
     uint64_t xbzrle_bytes;
     uint64_t xbzrle_pages;
     uint64_t xbzrle_cache_miss;
+    uint64_t xbzrle_cache_hits;
     uint64_t xbzrle_overflows;
 } AccountingInfo;
 
@@ -247,6 +271,11 @@ uint64_t xbzrle_mig_pages_cache_miss(void)
     return acct_info.xbzrle_cache_miss;
 }
 
+uint64_t xbzrle_mig_pages_cache_hit(void)
+{
+    return acct_info.xbzrle_cache_hits;
+}
+
 uint64_t xbzrle_mig_pages_overflow(void)
 {
     return acct_info.xbzrle_overflows;
@@ -285,6 +314,7 @@ static int save_xbzrle_page(QEMUFile *f, uint8_t *current_data,
         acct_info.xbzrle_cache_miss++;
         return -1;
     }
+    acct_info.xbzrle_cache_hits++;
 
     prev_cached_page = get_cached_data(XBZRLE.cache, current_addr);
 
@@ -478,6 +508,7 @@ static int ram_save_block(QEMUFile *f, bool last_stage)
         } else {
             int ret;
             uint8_t *p;
+            bool send_async = true;
             int cont = (block == last_sent_block) ?
                 RAM_SAVE_FLAG_CONTINUE : 0;
 
@@ -508,13 +539,20 @@ static int ram_save_block(QEMUFile *f, bool last_stage)
                                               offset, cont, last_stage);
                 if (!last_stage) {
                     p = get_cached_data(XBZRLE.cache, current_addr);
+                    /* The cache reuses the buffer of an evicted page, so a
+                       later insert could overwrite it before it is sent */
+                    send_async = false;
                 }
             }
 
             /* XBZRLE overflow or normal page */
             if (bytes_sent == -1) {
                 bytes_sent = save_block_hdr(f, block, offset, cont, RAM_SAVE_FLAG_PAGE);
-                qemu_put_buffer_async(f, p, TARGET_PAGE_SIZE);
+                if (send_async) {
+                    qemu_put_buffer_async(f, p, TARGET_PAGE_SIZE);
+                } else {
+                    qemu_put_buffer(f, p, TARGET_PAGE_SIZE);
+                }
                 bytes_sent += TARGET_PAGE_SIZE;
                 acct_info.norm_pages++;
             }
@@ -532,6 +570,352 @@ static int ram_save_block(QEMUFile *f, bool last_stage)
     return bytes_sent;
 }
 
+/*
+ * Compressed RAM snapshots (-savevm-threads N).  savevm writes guest RAM as
+ * chunks of RAM_CHUNK_SIZE bytes instead of single pages.  Chunks are
+ * deflated N at a time in the thread pool of the main AioContext while the
+ * previous N are written out with vectored I/O, and loadvm inflates them
+ * the same way.  Every page of a chunk is tagged: clean pages are skipped,
+ * zero pages and pages that still match their -mem-golden image are only
+ * tagged, and the remaining pages form one zlib stream.
+ *
+ * Stream format: header with RAM_SAVE_FLAG_CHUNK, be16 number of pages,
+ * be32 identity of the golden image (RAMBlock.golden_id, 0 without one),
+ * one RAM_CHUNK_* byte per page, be32 length and the zlib data.  loadvm
+ * fails if the chunk has RAM_CHUNK_BASE pages and the RAM block is not
+ * mapped from a golden image with the same identity.
+ */
+
+#define RAM_CHUNK_SIZE  (256 * 1024)
+#define RAM_CHUNK_PAGES (RAM_CHUNK_SIZE >> TARGET_PAGE_BITS)
+
+enum {
+    RAM_CHUNK_SKIP,
+    RAM_CHUNK_ZERO,
+    RAM_CHUNK_BASE,
+    RAM_CHUNK_DATA,
+};
+
+typedef struct RAMChunkJob {
+    RAMBlock *block;
+    ram_addr_t offset;
+    uint8_t *host;
+    const uint8_t *base;        /* golden image of the chunk, or NULL */
+    int npages;
+    uint8_t kinds[RAM_CHUNK_PAGES];
+    uint8_t *buf;
+    uLong buf_size;
+    uLong len;
+    z_stream stream;
+    bool busy;
+    int ret;
+} RAMChunkJob;
+
+typedef struct RAMChunkBase {
+    RAMBlock *block;
+    uint8_t *base;
+} RAMChunkBase;
+
+static struct {
+    RAMChunkJob *jobs;
+    int nb_jobs;
+    int next_job;
+    bool save;
+    /* Next chunk to look at while saving */
+    RAMBlock *block;
+    ram_addr_t offset;
+    RAMChunkBase *bases;
+    int nb_bases;
+} ram_compress;
+
+static void ram_compress_init(int nb_jobs, bool save)
+{
+    RAMChunkJob *job;
+    int i;
+
+    ram_compress.jobs = g_new0(RAMChunkJob, nb_jobs);
+    ram_compress.nb_jobs = nb_jobs;
+    ram_compress.next_job = 0;
+    ram_compress.save = save;
+    for (i = 0; i < nb_jobs; i++) {
+        job = &ram_compress.jobs[i];
+        if (save) {
+            deflateInit(&job->stream, Z_BEST_SPEED);
+            job->buf_size = deflateBound(&job->stream, RAM_CHUNK_SIZE);
+        } else {
+            inflateInit(&job->stream);
+            job->buf_size = compressBound(RAM_CHUNK_SIZE);
+        }
+        job->buf = g_malloc(job->buf_size);
+    }
+}
+
+static void ram_chunk_wait(RAMChunkJob *job)
+{
+    while (job->busy) {
+        aio_poll(qemu_get_aio_context(), true);
+    }
+}
+
+static void ram_compress_fini(void)
+{
+    RAMChunkJob *job;
+    int i;
+
+    for (i = 0; i < ram_compress.nb_jobs; i++) {
+        job = &ram_compress.jobs[i];
+        ram_chunk_wait(job);
+        if (ram_compress.save) {
+            deflateEnd(&job->stream);
+        } else {
+            inflateEnd(&job->stream);
+        }
+        g_free(job->buf);
+    }
+    g_free(ram_compress.jobs);
+    ram_compress.jobs = NULL;
+    ram_compress.nb_jobs = 0;
+
+#ifndef _WIN32
+    for (i = 0; i < ram_compress.nb_bases; i++) {
+        if (ram_compress.bases[i].base) {
+            munmap(ram_compress.bases[i].base,
+                   ram_compress.bases[i].block->length);
+        }
+    }
+#endif
+    g_free(ram_compress.bases);
+    ram_compress.bases = NULL;
+    ram_compress.nb_bases = 0;
+}
+
+static uint32_t ram_chunk_golden_id(RAMBlock *block)
+{
+    return (block->flags & RAM_GOLDEN_MASK) ? block->golden_id : 0;
+}
+
+/* Read-only mapping of the golden image a RAM block was mapped from */
+static const uint8_t *ram_chunk_base(RAMBlock *block)
+{
+    void *base = NULL;
+    int i;
+
+    for (i = 0; i < ram_compress.nb_bases; i++) {
+        if (ram_compress.bases[i].block == block) {
+            return ram_compress.bases[i].base;
+        }
+    }
+#ifndef _WIN32
+    if (block->flags & RAM_GOLDEN_MASK) {
+        base = mmap(NULL, block->length, PROT_READ, MAP_SHARED, block->fd,
+                    GOLDEN_RAM_HEADER_SIZE);
+        if (base == MAP_FAILED) {
+            base = NULL;
+        }
+    }
+#endif
+    ram_compress.bases = g_renew(RAMChunkBase, ram_compress.bases,
+                                 ram_compress.nb_bases + 1);
+    ram_compress.bases[ram_compress.nb_bases].block = block;
+    ram_compress.bases[ram_compress.nb_bases].base = base;
+    ram_compress.nb_bases++;
+    return base;
+}
+
+static void ram_chunk_done(void *opaque, int ret)
+{
+    RAMChunkJob *job = opaque;
+
+    job->ret = ret;
+    job->busy = false;
+}
+
+static void ram_chunk_submit(RAMChunkJob *job, ThreadPoolFunc *func)
+{
+    ThreadPool *pool = aio_get_thread_pool(qemu_get_aio_context());
+
+    job->busy = true;
+    thread_pool_submit_aio(pool, func, job, ram_chunk_done, job);
+}
+
+/* Runs in a worker thread */
+static int ram_chunk_deflate(void *opaque)
+{
+    RAMChunkJob *job = opaque;
+    z_stream *s = &job->stream;
+    uint8_t *p;
+    int i;
+
+    if (deflateReset(s) != Z_OK) {
+        return -EIO;
+    }
+    s->next_out = job->buf;
+    s->avail_out = job->buf_size;
+    for (i = 0; i < job->npages; i++) {
+        if (job->kinds[i] == RAM_CHUNK_SKIP) {
+            continue;
+        }
+        p = job->host + (i << TARGET_PAGE_BITS);
+        if (is_zero_range(p, TARGET_PAGE_SIZE)) {
+            job->kinds[i] = RAM_CHUNK_ZERO;
+        } else if (job->base &&
+                   !memcmp(p, job->base + (i << TARGET_PAGE_BITS),
+                           TARGET_PAGE_SIZE)) {
+            job->kinds[i] = RAM_CHUNK_BASE;
+        } else {
+            job->kinds[i] = RAM_CHUNK_DATA;
+            s->next_in = p;
+            s->avail_in = TARGET_PAGE_SIZE;
+            if (deflate(s, Z_NO_FLUSH) != Z_OK) {
+                return -EIO;
+            }
+        }
+    }
+    if (deflate(s, Z_FINISH) != Z_STREAM_END) {
+        return -EIO;
+    }
+    job->len = s->total_out;
+    return 0;
+}
+
+/*
+ * Claim the dirty pages of the next chunk that has any.  Returns false
+ * when the end of guest RAM has been reached.
+ */
+static bool ram_chunk_next(RAMChunkJob *job)
+{
+    RAMBlock *block = ram_compress.block;
+    ram_addr_t offset = ram_compress.offset;
+    const uint8_t *base;
+    unsigned long first, nr, i;
+
+    for (; block; block = QTAILQ_NEXT(block, next), offset = 0) {
+        for (; offset < block->length; offset += nr << TARGET_PAGE_BITS) {
+            first = (block->offset + offset) >> TARGET_PAGE_BITS;
+            nr = MIN(RAM_CHUNK_SIZE, block->length - offset) >>
+                 TARGET_PAGE_BITS;
+            if (find_next_bit(migration_bitmap, first + nr, first) >=
+                first + nr) {
+                continue;
+            }
+
+            for (i = 0; i < nr; i++) {
+                if (test_and_clear_bit(first + i, migration_bitmap)) {
+                    job->kinds[i] = RAM_CHUNK_DATA;
+                    migration_dirty_pages--;
+                } else {
+                    job->kinds[i] = RAM_CHUNK_SKIP;
+                }
+            }
+            base = ram_chunk_base(block);
+            job->block = block;
+            job->offset = offset;
+            job->host = memory_region_get_ram_ptr(block->mr) + offset;
+            job->base = base ? base + offset : NULL;
+            job->npages = nr;
+
+            ram_compress.block = block;
+            ram_compress.offset = offset + (nr << TARGET_PAGE_BITS);
+            return true;
+        }
+    }
+    ram_compress.block = NULL;
+    ram_compress.offset = 0;
+    return false;
+}
+
+static int ram_chunk_put(QEMUFile *f, RAMChunkJob *job)
+{
+    int cont = (job->block == last_sent_block) ? RAM_SAVE_FLAG_CONTINUE : 0;
+    int bytes_sent = 0;
+    uint8_t *p;
+    int i;
+
+    ram_chunk_wait(job);
+    if (job->ret < 0) {
+        /* Cannot happen with a deflateBound() buffer; send plain pages */
+        for (i = 0; i < job->npages; i++) {
+            if (job->kinds[i] == RAM_CHUNK_SKIP) {
+                continue;
+            }
+            p = job->host + (i << TARGET_PAGE_BITS);
+            bytes_sent += save_block_hdr(f, job->block,
+                                         job->offset + (i << TARGET_PAGE_BITS),
+                                         cont, RAM_SAVE_FLAG_PAGE);
+            qemu_put_buffer(f, p, TARGET_PAGE_SIZE);
+            bytes_sent += TARGET_PAGE_SIZE;
+            acct_info.norm_pages++;
+            cont = RAM_SAVE_FLAG_CONTINUE;
+        }
+        last_sent_block = job->block;
+        return bytes_sent;
+    }
+
+    bytes_sent = save_block_hdr(f, job->block, job->offset, cont,
+                                RAM_SAVE_FLAG_CHUNK);
+    qemu_put_be16(f, job->npages);
+    qemu_put_be32(f, ram_chunk_golden_id(job->block));
+    qemu_put_buffer(f, job->kinds, job->npages);
+    qemu_put_be32(f, job->len);
+    qemu_put_buffer_async(f, job->buf, job->len);
+    bytes_sent += 2 + 4 + job->npages + 4 + job->len;
+    last_sent_block = job->block;
+
+    for (i = 0; i < job->npages; i++) {
+        switch (job->kinds[i]) {
+        case RAM_CHUNK_ZERO:
+            acct_info.dup_pages++;
+            break;
+        case RAM_CHUNK_BASE:
+            acct_info.skipped_pages++;
+            break;
+        case RAM_CHUNK_DATA:
+            acct_info.norm_pages++;
+            break;
+        }
+    }
+    return bytes_sent;
+}
+
+/*
+ * ram_save_chunks: Writes all dirty pages as compressed chunks.  One half
+ * of the jobs is compressed while the other half is written, and the
+ * stream is flushed before the buffers of a half are reused.
+ *
+ * Returns:  The number of bytes written.
+ */
+static int64_t ram_save_chunks(QEMUFile *f)
+{
+    int batch = ram_compress.nb_jobs / 2;
+    RAMChunkJob *jobs[2] = {
+        ram_compress.jobs, ram_compress.jobs + batch
+    };
+    int nb[2] = { 0, 0 };
+    int64_t bytes_sent = 0;
+    int cur = 0, i;
+
+    ram_compress.block = QTAILQ_FIRST(&ram_list.blocks);
+    ram_compress.offset = 0;
+    do {
+        for (nb[cur] = 0; nb[cur] < batch; nb[cur]++) {
+            if (!ram_chunk_next(&jobs[cur][nb[cur]])) {
+                break;
+            }
+            ram_chunk_submit(&jobs[cur][nb[cur]], ram_chunk_deflate);
+        }
+        cur ^= 1;
+        for (i = 0; i < nb[cur]; i++) {
+            bytes_sent += ram_chunk_put(f, &jobs[cur][i]);
+        }
+        if (nb[cur]) {
+            qemu_fflush(f);
+        }
+        nb[cur] = 0;
+    } while (nb[cur ^ 1]);
+
+    return bytes_sent;
+}
+
 static uint64_t bytes_transferred;
 
 void acct_update_position(QEMUFile *f, size_t size, bool zero)
@@ -588,6 +972,10 @@ static void migration_end(void)
         g_free(XBZRLE.decoded_buf);
         XBZRLE.cache = NULL;
     }
+
+    if (ram_compress.jobs) {
+        ram_compress_fini();
+    }
 }
 
 static void ram_migration_cancel(void *opaque)
@@ -630,6 +1018,12 @@ static int ram_save_setup(QEMUFile *f, void *opaque)
         acct_clear();
     }
 
+    /* Only for snapshots, the migration thread must not use aio_poll() */
+    if (savevm_threads && !migration_in_setup(migrate_get_current())) {
+        ram_compress_init(savevm_threads * 2, true);
+        acct_clear();
+    }
+
     qemu_mutex_lock_iothread();
     qemu_mutex_lock_ramlist();
     bytes_transferred = 0;
@@ -670,11 +1064,18 @@ static int ram_save_iterate(QEMUFile *f, void *opaque)
         reset_ram_globals();
     }
 
+    xbzrle_cache_apply_resize(f);
+
     ram_control_before_iterate(f, RAM_CONTROL_ROUND);
 
+    if (ram_compress.jobs) {
+        total_sent = MIN(ram_save_chunks(f), INT_MAX);
+        acct_info.iterations++;
+    }
+
     t0 = qemu_clock_get_ns(QEMU_CLOCK_REALTIME);
     i = 0;
-    while ((ret = qemu_file_rate_limit(f)) == 0) {
+    while (!ram_compress.jobs && (ret = qemu_file_rate_limit(f)) == 0) {
         int bytes_sent;
 
         bytes_sent = ram_save_block(f, false);
@@ -735,6 +1136,10 @@ static int ram_save_complete(QEMUFile *f, void *opaque)
 
     /* try transferring iterative blocks of memory */
 
+    if (ram_compress.jobs) {
+        bytes_transferred += ram_save_chunks(f);
+    }
+
     /* flush all remaining blocks regardless of rate limiting */
     while (true) {
         int bytes_sent;
@@ -812,9 +1217,7 @@ static int load_xbzrle(QEMUFile *f, ram_addr_t addr, void *host)
     return rc;
 }
 
-static inline void *host_from_stream_offset(QEMUFile *f,
-                                            ram_addr_t offset,
-                                            int flags)
+static inline RAMBlock *block_from_stream(QEMUFile *f, int flags)
 {
     static RAMBlock *block = NULL;
     char id[256];
@@ -826,7 +1229,7 @@ static inline void *host_from_stream_offset(QEMUFile *f,
             return NULL;
         }
 
-        return memory_region_get_ram_ptr(block->mr) + offset;
+        return block;
     }
 
     len = qemu_get_byte(f);
@@ -835,13 +1238,25 @@ static inline void *host_from_stream_offset(QEMUFile *f,
 
     QTAILQ_FOREACH(block, &ram_list.blocks, next) {
         if (!strncmp(id, block->idstr, sizeof(id)))
-            return memory_region_get_ram_ptr(block->mr) + offset;
+            return block;
     }
 
     fprintf(stderr, "Can't find block %s!\n", id);
     return NULL;
 }
 
+static inline void *host_from_stream_offset(QEMUFile *f,
+                                            ram_addr_t offset,
+                                            int flags)
+{
+    RAMBlock *block = block_from_stream(f, flags);
+
+    if (!block) {
+        return NULL;
+    }
+    return memory_region_get_ram_ptr(block->mr) + offset;
+}
+
 /*
  * If a page (or a whole RDMA chunk) has been
  * determined to be zero, then zap it.
@@ -853,6 +1268,134 @@ void ram_handle_compressed(void *host, uint8_t ch, uint64_t size)
     }
 }
 
+/* Runs in a worker thread */
+static int ram_chunk_inflate(void *opaque)
+{
+    RAMChunkJob *job = opaque;
+    z_stream *s = &job->stream;
+    const uint8_t *base;
+    uint8_t *p;
+    int i, ret;
+
+    if (inflateReset(s) != Z_OK) {
+        return -EIO;
+    }
+    s->next_in = job->buf;
+    s->avail_in = job->len;
+    for (i = 0; i < job->npages; i++) {
+        p = job->host + (i << TARGET_PAGE_BITS);
+        switch (job->kinds[i]) {
+        case RAM_CHUNK_SKIP:
+            break;
+        case RAM_CHUNK_ZERO:
+            ram_handle_compressed(p, 0, TARGET_PAGE_SIZE);
+            break;
+        case RAM_CHUNK_BASE:
+            /* Only copy if it differs, to keep the page shared */
+            base = job->base + (i << TARGET_PAGE_BITS);
+            if (memcmp(p, base, TARGET_PAGE_SIZE)) {
+                memcpy(p, base, TARGET_PAGE_SIZE);
+            }
+            break;
+        case RAM_CHUNK_DATA:
+            s->next_out = p;
+            s->avail_out = TARGET_PAGE_SIZE;
+            ret = inflate(s, Z_SYNC_FLUSH);
+            if ((ret != Z_OK && ret != Z_STREAM_END) || s->avail_out) {
+                return -EIO;
+            }
+            break;
+        default:
+            return -EINVAL;
+        }
+    }
+    return 0;
+}
+
+/* Wait for all chunks that are being loaded, returns the first error */
+static int ram_load_chunks_wait(void)
+{
+    int i, ret = 0;
+
+    for (i = 0; i < ram_compress.nb_jobs; i++) {
+        ram_chunk_wait(&ram_compress.jobs[i]);
+        if (ram_compress.jobs[i].ret < 0 && !ret) {
+            ret = ram_compress.jobs[i].ret;
+        }
+        ram_compress.jobs[i].ret = 0;
+    }
+    return ret;
+}
+
+static int ram_load_chunk(QEMUFile *f, ram_addr_t addr, int flags)
+{
+    RAMBlock *block;
+    RAMChunkJob *job;
+    const uint8_t *base;
+    uint32_t golden_id;
+    int i, npages;
+
+    block = block_from_stream(f, flags);
+    if (!block) {
+        return -EINVAL;
+    }
+    npages = qemu_get_be16(f);
+    if (npages > RAM_CHUNK_PAGES ||
+        addr + ((ram_addr_t)npages << TARGET_PAGE_BITS) > block->length) {
+        fprintf(stderr, "Bad compressed RAM chunk in %s\n", block->idstr);
+        return -EINVAL;
+    }
+    golden_id = qemu_get_be32(f);
+
+    if (!ram_compress.jobs) {
+        ram_compress_init(MAX(savevm_threads, 1) * 2, false);
+    }
+    job = &ram_compress.jobs[ram_compress.next_job];
+    ram_compress.next_job = (ram_compress.next_job + 1) % ram_compress.nb_jobs;
+    ram_chunk_wait(job);
+    if (job->ret < 0) {
+        return job->ret;
+    }
+
+    qemu_get_buffer(f, job->kinds, npages);
+    job->len = qemu_get_be32(f);
+    if (job->len > job->buf_size) {
+        fprintf(stderr, "Bad compressed RAM chunk in %s\n", block->idstr);
+        return -EINVAL;
+    }
+    qemu_get_buffer(f, job->buf, job->len);
+
+    base = ram_chunk_base(block);
+    job->block = block;
+    job->offset = addr;
+    job->host = memory_region_get_ram_ptr(block->mr) + addr;
+    job->base = base ? base + addr : NULL;
+    job->npages = npages;
+    for (i = 0; i < npages; i++) {
+        if (job->kinds[i] != RAM_CHUNK_BASE) {
+            continue;
+        }
+        if (!job->base) {
+            fprintf(stderr, "Snapshot of %s needs its -mem-golden image\n",
+                    block->idstr);
+            return -EINVAL;
+        }
+        if (ram_chunk_golden_id(block) != golden_id) {
+            fprintf(stderr, "Snapshot of %s was saved with another "
+                    "-mem-golden image\n", block->idstr);
+            return -EINVAL;
+        }
+    }
+
+    /* Without -savevm-threads, or in the incoming migration coroutine,
+       which must not wait in aio_poll(), inflate right here */
+    if (!savevm_threads || qemu_in_coroutine()) {
+        return ram_chunk_inflate(job);
+    }
+    ram_chunk_submit(job, ram_chunk_inflate);
+    return 0;
+}
+
 static int ram_load(QEMUFile *f, void *opaque, int version_id)
 {
     ram_addr_t addr;
@@ -920,7 +1463,8 @@ static int ram_load(QEMUFile *f, void *opaque, int version_id)
 
             host = host_from_stream_offset(f, addr, flags);
             if (!host) {
-                return -EINVAL;
+                ret = -EINVAL;
+                goto done;
             }
 
             ch = qemu_get_byte(f);
@@ -930,20 +1474,27 @@ static int ram_load(QEMUFile *f, void *opaque, int version_id)
 
             host = host_from_stream_offset(f, addr, flags);
             if (!host) {
-                return -EINVAL;
+                ret = -EINVAL;
+                goto done;
             }
 
             qemu_get_buffer(f, host, TARGET_PAGE_SIZE);
         } else if (flags & RAM_SAVE_FLAG_XBZRLE) {
             void *host = host_from_stream_offset(f, addr, flags);
             if (!host) {
-                return -EINVAL;
+                ret = -EINVAL;
+                goto done;
             }
 
             if (load_xbzrle(f, addr, host) < 0) {
                 ret = -EINVAL;
                 goto done;
             }
+        } else if (flags & RAM_SAVE_FLAG_CHUNK) {
+            ret = ram_load_chunk(f, addr, flags);
+            if (ret < 0) {
+                goto done;
+            }
         } else if (flags & RAM_SAVE_FLAG_HOOK) {
             ram_control_load_hook(f, flags);
         }
@@ -955,6 +1506,13 @@ static int ram_load(QEMUFile *f, void *opaque, int version_id)
     } while (!(flags & RAM_SAVE_FLAG_EOS));
 
 done:
+    if (ram_compress.jobs && !ram_compress.save) {
+        error = ram_load_chunks_wait();
+        if (error && !ret) {
+            ret = error;
+        }
+        ram_compress_fini();
+    }
     DPRINTF("Completed load of VM with exit code %d seq iteration "
             "%" PRIu64 "\n", ret, seq_iter);
     return ret;
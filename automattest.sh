@@ -20,7 +20,8 @@ SBST_CYCLE_COUNT=$ ( echo $SBST_CYCLE_COUNT | cut -f2 -d : )
 SBST_CYCLE_COUNT=$ ( echo $SBST_CYCLE_COUNT | cut -f1 -d ' ' )
 echo "SBST_CYCLE_COUNT: $SBST_CYCLE_COUNT"
 qemu-system-arm -M imx28evk -m 128 -kernel $KERNEL_PATH -fi \
-$FAULT_COUNTER_ADDRESS,$FAULT_LIBRARY_PATH,$SBST_CYCLE_COUNT
+$FAULT_COUNTER_ADDRESS,$FAULT_LIBRARY_PATH,$SBST_CYCLE_COUNT \
+-fi-campaign file=campaign.tsv,experiment=$counter
 DATA_COLLECTOR_OUT="data_collector_$counter.txt"
 cat $DATA_COLLECTOR_PATH > $DATA_COLLECTOR_OUT
 counter=$((counter+1))
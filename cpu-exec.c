@@ -22,6 +22,7 @@
 #include "tcg.h"
 #include "qemu/atomic.h"
 #include "sysemu/qtest.h"
+#include "sysemu/cpus.h"
 
 #include "fault-injection-controller.h"
 
@@ -49,6 +50,72 @@ void cpu_resume_from_signal(CPUArchState *env, void *puc)
     env->exception_index = -1;
     siglongjmp(env->jmp_env, 1);
 }
+
+/* Busy-wait detection.  A guest polling device registers in a tight loop
+   (e.g. waiting for a timer to expire) cannot make progress until the
+   next timer deadline, so QEMU_CLOCK_VIRTUAL is warped forward to it
+   instead of letting the loop spin in real time.  A loop qualifies once
+   BUSY_WAIT_READS MMIO reads in a row came from at most BUSY_WAIT_SITES
+   load instructions, each always reading the same register, without any
+   MMIO write in between, and the reading TB is part of a chained cycle of
+   at most BUSY_WAIT_LOOP_TBS TBs that do not store to guest memory.  */
+#define BUSY_WAIT_READS     256
+#define BUSY_WAIT_SITES     4
+#define BUSY_WAIT_LOOP_TBS  2
+
+typedef struct BusyWaitSite {
+    uintptr_t retaddr;
+    hwaddr physaddr;
+} BusyWaitSite;
+
+static struct {
+    CPUArchState *env;
+    BusyWaitSite site[BUSY_WAIT_SITES];
+    int nb_sites;
+    unsigned int reads;
+} busy_wait;
+
+void cpu_busy_wait_mmio_read(CPUArchState *env, hwaddr physaddr,
+                             uintptr_t retaddr)
+{
+    int i;
+
+    if (env != busy_wait.env) {
+        busy_wait.env = env;
+        cpu_busy_wait_mmio_write();
+    }
+    for (i = 0; i < busy_wait.nb_sites; i++) {
+        if (busy_wait.site[i].retaddr == retaddr) {
+            break;
+        }
+    }
+    if (i == busy_wait.nb_sites || busy_wait.site[i].physaddr != physaddr) {
+        /* a new load site, or a known one reading another register */
+        if (i < busy_wait.nb_sites || i == BUSY_WAIT_SITES) {
+            busy_wait.nb_sites = 0;
+        }
+        busy_wait.site[busy_wait.nb_sites].retaddr = retaddr;
+        busy_wait.site[busy_wait.nb_sites].physaddr = physaddr;
+        busy_wait.nb_sites++;
+        busy_wait.reads = 0;
+        return;
+    }
+    if (++busy_wait.reads < BUSY_WAIT_READS) {
+        return;
+    }
+    busy_wait.reads = 0;
+    if (!tb_is_store_free_loop(retaddr, BUSY_WAIT_LOOP_TBS)) {
+        return;
+    }
+    /* never warp across the start or end of a time-triggered fault */
+    qemu_clock_warp_to_deadline(fault_injection_controller_next_deadline());
+}
+
+void cpu_busy_wait_mmio_write(void)
+{
+    busy_wait.nb_sites = 0;
+    busy_wait.reads = 0;
+}
 #endif
 
 /* Execute a TB, and fix up the CPU state afterwards if necessary */
@@ -147,6 +214,10 @@ static TranslationBlock *tb_find_slow(CPUArchState *env,
     tb = tb_gen_code(env, pc, cs_base, flags, 0);
 
  found:
+    if (unlikely(tb->cflags & CF_PREFETCHED)) {
+        tb->cflags &= ~CF_PREFETCHED;
+        tcg_ctx.tb_ctx.tb_prefetch_hit_count++;
+    }
     /* Move the last found TB to the head of the list */
     if (likely(*ptb1)) {
         *ptb1 = tb->phys_hash_next;
@@ -185,6 +256,76 @@ static inline TranslationBlock *tb_find_fast(CPUArchState *env)
     return tb;
 }
 
+/* Look up the next TB for the current CPU state from generated code, so
+   that indirect branches can jump straight to it with goto_ptr.  Only the
+   virtual PC jump cache is consulted: translating here would be unsafe, so
+   on a miss we return the epilogue and let cpu_exec() find or generate the
+   TB.  Pending interrupts are caught by the exit request check at the start
+   of every TB.  */
+void *tb_lookup_tc_ptr(CPUArchState *env)
+{
+    TranslationBlock *tb;
+    target_ulong cs_base, pc;
+    int flags;
+
+    cpu_get_tb_cpu_state(env, &pc, &cs_base, &flags);
+
+    tb = env->tb_jmp_cache[tb_jmp_cache_hash_func(pc)];
+    if (unlikely(!tb || tb->pc != pc || tb->cs_base != cs_base ||
+                 tb->flags != flags)) {
+        return tcg_ctx.code_gen_epilogue;
+    }
+    /* TBs that are still being profiled are only entered from cpu_exec() */
+    if (tb->exec_count < superblock_threshold) {
+        return tcg_ctx.code_gen_epilogue;
+    }
+    return tb->tc_ptr;
+}
+
+#ifdef TARGET_HAS_SUPERBLOCKS
+/* Profile TBs for -superblocks.  A TB is not chained until it has been
+   executed superblock_threshold times, so that every execution and every
+   exit through jump 0 (the taken branch) passes through here.  A TB that
+   reaches the threshold is replaced by a superblock that follows the
+   usual direction of its final branch.  Sets *next_tb to 0 if the
+   previous TB must not be chained to the returned one.  */
+static TranslationBlock *tb_profile(CPUArchState *env, TranslationBlock *tb,
+                                    uintptr_t *next_tb)
+{
+    TranslationBlock *prev = (TranslationBlock *)(*next_tb & ~TB_EXIT_MASK);
+    target_ulong pc, cs_base;
+    uint64_t flags;
+    int cflags;
+
+    if (prev && prev->exec_count < superblock_threshold) {
+        if ((*next_tb & TB_EXIT_MASK) == 0) {
+            prev->taken_count++;
+        }
+        *next_tb = 0;
+    }
+    if (tb->exec_count >= superblock_threshold) {
+        return tb;
+    }
+    *next_tb = 0;
+    if (++tb->exec_count < superblock_threshold) {
+        return tb;
+    }
+
+    cflags = CF_SUPERBLOCK;
+    if (tb->taken_count * 2 > tb->exec_count) {
+        cflags |= CF_SB_TAKEN;
+    }
+    pc = tb->pc;
+    cs_base = tb->cs_base;
+    flags = tb->flags;
+    tb_phys_invalidate(tb, -1);
+    tb = tb_gen_code(env, pc, cs_base, flags, cflags);
+    tb->exec_count = superblock_threshold;
+    env->tb_jmp_cache[tb_jmp_cache_hash_func(pc)] = tb;
+    return tb;
+}
+#endif
+
 static CPUDebugExcpHandler *debug_excp_handler;
 
 void cpu_set_debug_excp_handler(CPUDebugExcpHandler *handler)
@@ -617,6 +758,11 @@ int cpu_exec(CPUArchState *env)
                     next_tb = 0;
                     tcg_ctx.tb_ctx.tb_invalidated_flag = 0;
                 }
+#ifdef TARGET_HAS_SUPERBLOCKS
+                if (superblock_threshold) {
+                    tb = tb_profile(env, tb, &next_tb);
+                }
+#endif
                 if (qemu_loglevel_mask(CPU_LOG_EXEC)) {
                     qemu_log("Trace %p [" TARGET_FMT_lx "] %s\n",
                              tb->tc_ptr, tb->pc, lookup_symbol(tb->pc));
@@ -363,6 +363,40 @@ void qtest_clock_warp(int64_t dest)
     qemu_clock_notify(QEMU_CLOCK_VIRTUAL);
 }
 
+/* Advance QEMU_CLOCK_VIRTUAL to its earliest timer deadline, but by no
+ * more than 'limit' ns unless it is negative.  This is for a guest that is
+ * known to do nothing but wait for that timer; unlike the icount warp
+ * above it also works without -icount, where it just looks like the vCPU
+ * was descheduled for a while.  Returns the warp in ns.
+ * Caller must hold the BQL.
+ */
+int64_t qemu_clock_warp_to_deadline(int64_t limit)
+{
+    int64_t deadline;
+
+    if (!runstate_is_running()) {
+        return 0;
+    }
+    deadline = qemu_clock_deadline_ns_all(QEMU_CLOCK_VIRTUAL);
+    if (limit >= 0 && (deadline < 0 || limit < deadline)) {
+        deadline = limit;
+    }
+    if (deadline <= 0) {
+        return 0;
+    }
+
+    seqlock_write_lock(&timers_state.vm_clock_seqlock);
+    if (use_icount) {
+        qemu_icount_bias += deadline;
+    } else {
+        timers_state.cpu_clock_offset += deadline;
+    }
+    seqlock_write_unlock(&timers_state.vm_clock_seqlock);
+
+    qemu_clock_notify(QEMU_CLOCK_VIRTUAL);
+    return deadline;
+}
+
 void qemu_clock_warp(QEMUClockType type)
 {
     int64_t clock;
@@ -821,6 +855,24 @@ static void qemu_wait_io_event_common(CPUState *cpu)
     cpu->thread_kicked = false;
 }
 
+/* With -tb-prefetch, use the time the halted CPUs wait for an interrupt
+   to translate code they may run next.  Translation needs the global
+   mutex, so only a few blocks are translated at a time and none while the
+   I/O thread is waiting for it.  Returns true if anything was translated. */
+static bool qemu_tcg_prefetch(void)
+{
+    int n = 0;
+
+    if (!tb_prefetch_size || !runstate_is_running()) {
+        return false;
+    }
+    while (n < 16 && !iothread_requesting_mutex &&
+           tb_prefetch(first_cpu->env_ptr)) {
+        n++;
+    }
+    return n > 0;
+}
+
 static void qemu_tcg_wait_io_event(void)
 {
     CPUState *cpu;
@@ -829,6 +881,9 @@ static void qemu_tcg_wait_io_event(void)
        /* Start accounting real time to the virtual clock if the CPUs
           are idle.  */
         qemu_clock_warp(QEMU_CLOCK_VIRTUAL);
+        if (qemu_tcg_prefetch()) {
+            continue;
+        }
         qemu_cond_wait(tcg_halt_cond, &qemu_global_mutex);
     }
 
@@ -26,6 +26,7 @@
 #include "exec/cputlb.h"
 
 #include "exec/memory-internal.h"
+#include "fault-injection-controller.h"
 
 //#define DEBUG_TLB
 //#define DEBUG_TLB_CHECK
@@ -191,8 +192,8 @@ void cpu_tlb_reset_dirty_all(ram_addr_t start1, ram_addr_t length)
 
 static inline void tlb_set_dirty1(CPUTLBEntry *tlb_entry, target_ulong vaddr)
 {
-    if (tlb_entry->addr_write == (vaddr | TLB_NOTDIRTY)) {
-        tlb_entry->addr_write = vaddr;
+    if ((tlb_entry->addr_write & ~TLB_FAULT) == (vaddr | TLB_NOTDIRTY)) {
+        tlb_entry->addr_write &= ~TLB_NOTDIRTY;
     }
 }
 
@@ -307,6 +308,16 @@ void tlb_set_page(CPUArchState *env, target_ulong vaddr,
     } else {
         te->addr_write = -1;
     }
+
+    /* Keep pages with armed memory faults on the slow path.  */
+    if (fault_injection_controller_page_armed(vaddr)) {
+        if (te->addr_read != -1) {
+            te->addr_read |= TLB_FAULT;
+        }
+        if (te->addr_write != -1) {
+            te->addr_write |= TLB_FAULT;
+        }
+    }
 }
 
 /* NOTE: this function can trigger an exception */
@@ -20,6 +20,16 @@
 #include "disas/bfd.h"
 #include "tcg/tcg.h"
 
+#if TCI_THREADED
+static const char *const tci_fast_names[] = {
+    "add_i32_rr", "add_i32_ri", "sub_i32_rr", "sub_i32_ri",
+    "and_i32_rr", "and_i32_ri", "or_i32_rr", "or_i32_ri",
+    "xor_i32_rr", "xor_i32_ri", "shl_i32_rr", "shl_i32_ri",
+    "shr_i32_rr", "shr_i32_ri", "sar_i32_rr", "sar_i32_ri",
+    "brcond_i32_rr", "brcond_i32_ri",
+};
+#endif
+
 /* Disassemble TCI bytecode. */
 int print_insn_tci(bfd_vma addr, disassemble_info *info)
 {
@@ -43,6 +53,12 @@ int print_insn_tci(bfd_vma addr, disassemble_info *info)
     }
     length = byte;
 
+#if TCI_THREADED
+    if (op >= tcg_op_defs_max && op < TCI_NB_OPS) {
+        info->fprintf_func(info->stream, "%s",
+                           tci_fast_names[op - tcg_op_defs_max]);
+    } else
+#endif
     if (op >= tcg_op_defs_max) {
         info->fprintf_func(info->stream, "illegal opcode %d", op);
     } else {
@@ -29,7 +29,9 @@
 #include "tcg.h"
 #include "hw/hw.h"
 #include "hw/qdev.h"
+#include "hw/boards.h"
 #include "qemu/osdep.h"
+#include "qemu/crc32c.h"
 #include "sysemu/kvm.h"
 #include "sysemu/sysemu.h"
 #include "hw/xen/xen.h"
@@ -51,6 +53,7 @@
 
 #include "exec/memory-internal.h"
 #include "fault-injection-controller.h"
+#include "fault-injection-journal.h"
 
 //#define DEBUG_SUBPAGE
 
@@ -91,6 +94,13 @@ struct PhysPageEntry {
 
 typedef PhysPageEntry Node[L2_SIZE];
 
+#define PHYS_CACHE_SIZE 4
+
+typedef struct PhysCacheEntry {
+    hwaddr index;
+    MemoryRegionSection *section;
+} PhysCacheEntry;
+
 struct AddressSpaceDispatch {
     /* This is a multi-level map on the physical address space.
      * The bottom level has pointers to MemoryRegionSections.
@@ -99,6 +109,11 @@ struct AddressSpaceDispatch {
     Node *nodes;
     MemoryRegionSection *sections;
     AddressSpace *as;
+    /* The last pages looked up in phys_map, most recent first.  A new
+     * dispatch is built on every topology change, so this never needs
+     * to be invalidated.
+     */
+    PhysCacheEntry cache[PHYS_CACHE_SIZE];
 };
 
 #define SUBPAGE_IDX(addr) ((addr) & ~TARGET_PAGE_MASK)
@@ -230,6 +245,30 @@ bool memory_region_is_unassigned(MemoryRegion *mr)
         && mr != &io_mem_watch;
 }
 
+static MemoryRegionSection *phys_page_find_cached(AddressSpaceDispatch *d,
+                                                  hwaddr index)
+{
+    PhysCacheEntry e;
+    int i;
+
+    for (i = 0; i < PHYS_CACHE_SIZE; i++) {
+        if (d->cache[i].index == index) {
+            if (i == 0) {
+                return d->cache[0].section;
+            }
+            e = d->cache[i];
+            goto hit;
+        }
+    }
+    e.index = index;
+    e.section = phys_page_find(d->phys_map, index, d->nodes, d->sections);
+    i = PHYS_CACHE_SIZE - 1;
+hit:
+    memmove(&d->cache[1], &d->cache[0], i * sizeof(e));
+    d->cache[0] = e;
+    return e.section;
+}
+
 static MemoryRegionSection *address_space_lookup_region(AddressSpaceDispatch *d,
                                                         hwaddr addr,
                                                         bool resolve_subpage)
@@ -237,8 +276,7 @@ static MemoryRegionSection *address_space_lookup_region(AddressSpaceDispatch *d,
     MemoryRegionSection *section;
     subpage_t *subpage;
 
-    section = phys_page_find(d->phys_map, addr >> TARGET_PAGE_BITS,
-                             d->nodes, d->sections);
+    section = phys_page_find_cached(d, addr >> TARGET_PAGE_BITS);
     if (resolve_subpage && section->mr->subpage) {
         subpage = container_of(section->mr, subpage_t, iomem);
         section = &d->sections[subpage->sub_section[SUBPAGE_IDX(addr)]];
@@ -992,6 +1030,264 @@ static void *file_ram_alloc(RAMBlock *block,
 }
 #endif
 
+#ifndef _WIN32
+/*
+ * Golden RAM images (-mem-golden DIR).  A RAM block is backed by a private
+ * mapping of DIR/<region name>, so that all processes started from the same
+ * image share the clean pages and only copy the ones they write to.  When
+ * the image is missing or was made for another machine, RAM block, kernel,
+ * initrd, device tree or command line, the block is allocated as usual and
+ * qemu_ram_save_golden() writes a new image once the machine is set up.
+ *
+ * File format: GoldenRAMHeader (little endian), padded to
+ * GOLDEN_RAM_HEADER_SIZE, followed by the contents of the RAM block.
+ */
+
+#define GOLDEN_RAM_MAGIC    "FIESGRAM"
+#define GOLDEN_RAM_VERSION  1
+
+typedef struct GoldenRAMHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t identity;          /* golden_ram_identity() */
+    uint64_t length;
+} GoldenRAMHeader;
+
+static uint32_t golden_ram_crc_str(uint32_t crc, const char *s)
+{
+    if (!s) {
+        s = "";
+    }
+    return crc32c(crc, (const uint8_t *)s, strlen(s) + 1);
+}
+
+static uint32_t golden_ram_crc_file(uint32_t crc, const char *filename)
+{
+    gchar *contents;
+    gsize len;
+
+    crc = golden_ram_crc_str(crc, filename);
+    if (filename && g_file_get_contents(filename, &contents, &len, NULL)) {
+        crc = crc32c(crc, (const uint8_t *)contents, len);
+        g_free(contents);
+    }
+    return crc;
+}
+
+/* Hash of everything the contents of a golden image depend on: the
+   machine type, the kernel, initrd and device tree, the kernel command
+   line, and the name and size of the RAM block.  */
+static uint32_t golden_ram_identity(RAMBlock *block, ram_addr_t memory)
+{
+    static bool machine_done;
+    static uint32_t machine_crc;
+    QemuOpts *opts;
+    uint64_t len;
+    uint32_t crc;
+
+    if (!machine_done) {
+        opts = qemu_get_machine_opts();
+        crc = golden_ram_crc_str(0xffffffff, current_machine ?
+                                 current_machine->name : NULL);
+        crc = golden_ram_crc_file(crc, qemu_opt_get(opts, "kernel"));
+        crc = golden_ram_crc_file(crc, qemu_opt_get(opts, "initrd"));
+        crc = golden_ram_crc_file(crc, qemu_opt_get(opts, "dtb"));
+        machine_crc = golden_ram_crc_str(crc, qemu_opt_get(opts, "append"));
+        machine_done = true;
+    }
+
+    len = cpu_to_le64(memory);
+    crc = golden_ram_crc_str(machine_crc, block->mr->name);
+    return crc32c(crc, (const uint8_t *)&len, sizeof(len));
+}
+
+/* Check the header of a golden image; prints why it cannot be used.  */
+static bool golden_ram_check(RAMBlock *block, ram_addr_t memory, int fd,
+                             const char *filename)
+{
+    GoldenRAMHeader hdr;
+    struct stat st;
+
+    if (pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr) ||
+        memcmp(hdr.magic, GOLDEN_RAM_MAGIC, sizeof(hdr.magic)) ||
+        le32_to_cpu(hdr.version) != GOLDEN_RAM_VERSION) {
+        fprintf(stderr, "-mem-golden: %s is not a golden RAM image of "
+                "version %d, writing a new one\n", filename,
+                GOLDEN_RAM_VERSION);
+        return false;
+    }
+    if (le32_to_cpu(hdr.identity) != block->golden_id ||
+        le64_to_cpu(hdr.length) != memory) {
+        fprintf(stderr, "-mem-golden: %s was made for another machine, RAM "
+                "size, kernel, initrd, dtb or command line, writing a new "
+                "one\n", filename);
+        return false;
+    }
+    if (fstat(fd, &st) < 0 || st.st_size != GOLDEN_RAM_HEADER_SIZE + memory) {
+        fprintf(stderr, "-mem-golden: %s is truncated, writing a new one\n",
+                filename);
+        return false;
+    }
+    return true;
+}
+
+static bool golden_ram_write(int fd, const void *buf, size_t left)
+{
+    const uint8_t *p = buf;
+    ssize_t len;
+
+    while (left > 0) {
+        len = write(fd, p, left);
+        if (len < 0 && errno == EINTR) {
+            continue;
+        }
+        if (len <= 0) {
+            return false;
+        }
+        p += len;
+        left -= len;
+    }
+    return true;
+}
+
+static char *golden_ram_filename(RAMBlock *block, const char *dir)
+{
+    char *sanitized_name;
+    char *filename;
+    char *c;
+
+    sanitized_name = g_strdup(block->mr->name);
+    for (c = sanitized_name; *c != '\0'; c++) {
+        if (*c == '/') {
+            *c = '_';
+        }
+    }
+    filename = g_strdup_printf("%s/%s", dir, sanitized_name);
+    g_free(sanitized_name);
+    return filename;
+}
+
+static void *golden_ram_alloc(RAMBlock *block, ram_addr_t memory,
+                              const char *dir)
+{
+    char *filename;
+    void *area;
+    int fd;
+
+    filename = golden_ram_filename(block, dir);
+    fd = qemu_open(filename, O_RDONLY);
+    if (fd < 0) {
+        g_free(filename);
+        return NULL;
+    }
+    if (!golden_ram_check(block, memory, fd, filename)) {
+        g_free(filename);
+        close(fd);
+        return NULL;
+    }
+    g_free(filename);
+
+    area = mmap(0, memory, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                GOLDEN_RAM_HEADER_SIZE);
+    if (area == MAP_FAILED) {
+        perror("golden_ram_alloc: can't mmap RAM pages");
+        close(fd);
+        return NULL;
+    }
+    block->fd = fd;
+    block->flags |= RAM_GOLDEN_MASK;
+    return area;
+}
+
+static void golden_ram_save(RAMBlock *block, const char *dir)
+{
+    char *filename, *tmpname;
+    GoldenRAMHeader *hdr;
+    bool ok;
+    int fd;
+
+    filename = golden_ram_filename(block, dir);
+    tmpname = g_strdup_printf("%s.XXXXXX", filename);
+    fd = mkstemp(tmpname);
+    if (fd < 0) {
+        perror("unable to create golden RAM image");
+        goto out;
+    }
+    hdr = g_malloc0(GOLDEN_RAM_HEADER_SIZE);
+    memcpy(hdr->magic, GOLDEN_RAM_MAGIC, sizeof(hdr->magic));
+    hdr->version = cpu_to_le32(GOLDEN_RAM_VERSION);
+    hdr->identity = cpu_to_le32(block->golden_id);
+    hdr->length = cpu_to_le64(block->length);
+    ok = golden_ram_write(fd, hdr, GOLDEN_RAM_HEADER_SIZE) &&
+         golden_ram_write(fd, block->host, block->length);
+    g_free(hdr);
+    if (!ok) {
+        perror("unable to write golden RAM image");
+        close(fd);
+        unlink(tmpname);
+        goto out;
+    }
+    close(fd);
+    /* Parallel processes may race to create the image; any copy will do */
+    if (rename(tmpname, filename) < 0) {
+        perror("unable to create golden RAM image");
+        unlink(tmpname);
+    }
+out:
+    g_free(tmpname);
+    g_free(filename);
+}
+#else
+static uint32_t golden_ram_identity(RAMBlock *block, ram_addr_t memory)
+{
+    return 0;
+}
+
+static void *golden_ram_alloc(RAMBlock *block, ram_addr_t memory,
+                              const char *dir)
+{
+    fprintf(stderr, "-mem-golden not supported on this host\n");
+    exit(1);
+}
+
+static void golden_ram_save(RAMBlock *block, const char *dir)
+{
+}
+#endif
+
+/* True if every RAM block was mapped from a golden image, so that guest
+   memory already holds the state the machine had after its first reset.  */
+bool qemu_ram_all_golden(void)
+{
+    RAMBlock *block;
+
+    if (!mem_golden || QTAILQ_EMPTY(&ram_list.blocks)) {
+        return false;
+    }
+    QTAILQ_FOREACH(block, &ram_list.blocks, next) {
+        if (!(block->flags & (RAM_GOLDEN_MASK | RAM_PREALLOC_MASK))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Write a golden image for every RAM block that was not mapped from one.
+   Called after the first system reset, when kernel and ROMs are loaded.  */
+void qemu_ram_save_golden(void)
+{
+    RAMBlock *block;
+
+    if (!mem_golden) {
+        return;
+    }
+    QTAILQ_FOREACH(block, &ram_list.blocks, next) {
+        if (!(block->flags & (RAM_GOLDEN_MASK | RAM_PREALLOC_MASK))) {
+            golden_ram_save(block, mem_golden);
+        }
+    }
+}
+
 static ram_addr_t find_ram_offset(ram_addr_t size)
 {
     RAMBlock *block, *next_block;
@@ -1122,7 +1418,16 @@ ram_addr_t qemu_ram_alloc_from_ptr(ram_addr_t size, void *host,
         }
         xen_ram_alloc(new_block->offset, size, mr);
     } else {
-        if (mem_path) {
+        if (mem_golden) {
+            if (phys_mem_alloc != qemu_anon_ram_alloc) {
+                fprintf(stderr,
+                        "-mem-golden not supported with this accelerator\n");
+                exit(1);
+            }
+            new_block->golden_id = golden_ram_identity(new_block, size);
+            new_block->host = golden_ram_alloc(new_block, size, mem_golden);
+        }
+        if (!new_block->host && mem_path) {
             if (phys_mem_alloc != qemu_anon_ram_alloc) {
                 /*
                  * file_ram_alloc() needs to allocate just like
@@ -1252,7 +1557,12 @@ void qemu_ram_remap(ram_addr_t addr, ram_addr_t length)
             } else {
                 flags = MAP_FIXED;
                 munmap(vaddr, length);
-                if (block->fd >= 0) {
+                if (block->flags & RAM_GOLDEN_MASK) {
+                    flags |= MAP_PRIVATE;
+                    area = mmap(vaddr, length, PROT_READ | PROT_WRITE,
+                                flags, block->fd,
+                                GOLDEN_RAM_HEADER_SIZE + offset);
+                } else if (block->fd >= 0) {
 #ifdef MAP_POPULATE
                     flags |= mem_prealloc ? MAP_POPULATE | MAP_SHARED :
                         MAP_PRIVATE;
@@ -1383,6 +1693,7 @@ static void notdirty_mem_write(void *opaque, hwaddr ram_addr,
         tb_invalidate_phys_page_fast(ram_addr, size);
         dirty_flags = cpu_physical_memory_get_dirty_flags(ram_addr);
     }
+    fies_journal_write(ram_addr, size);
     switch (size) {
     case 1:
         stb_p(qemu_get_ram_ptr(ram_addr), val);
@@ -1638,9 +1949,14 @@ static void mem_begin(MemoryListener *listener)
 {
     AddressSpace *as = container_of(listener, AddressSpace, dispatch_listener);
     AddressSpaceDispatch *d = g_new(AddressSpaceDispatch, 1);
+    int i;
 
     d->phys_map  = (PhysPageEntry) { .ptr = PHYS_MAP_NODE_NIL, .is_leaf = 0 };
     d->as = as;
+    for (i = 0; i < PHYS_CACHE_SIZE; i++) {
+        /* no page has this index */
+        d->cache[i].index = -1;
+    }
     as->next_dispatch = d;
 }
 
@@ -1914,6 +2230,7 @@ bool address_space_rw(AddressSpace *as, hwaddr addr, uint8_t *buf,
                 addr1 += memory_region_get_ram_addr(mr);
                 /* RAM case */
                 ptr = qemu_get_ram_ptr(addr1);
+                fies_journal_write(addr1, l);
                 memcpy(ptr, buf, l);
                 invalidate_and_set_dirty(addr1, l);
             }
@@ -2000,6 +2317,7 @@ void cpu_physical_memory_write_rom(hwaddr addr,
             addr1 += memory_region_get_ram_addr(mr);
             /* ROM/RAM case */
             ptr = qemu_get_ram_ptr(addr1);
+            fies_journal_write(addr1, l);
             memcpy(ptr, buf, l);
             invalidate_and_set_dirty(addr1, l);
         }
@@ -2094,6 +2412,7 @@ void *address_space_map(AddressSpace *as,
     hwaddr l, xlat, base;
     MemoryRegion *mr, *this_mr;
     ram_addr_t raddr;
+    void *ptr;
 
     if (len == 0) {
         return NULL;
@@ -2141,7 +2460,12 @@ void *address_space_map(AddressSpace *as,
 
     memory_region_ref(mr);
     *plen = done;
-    return qemu_ram_ptr_length(raddr + base, plen);
+    ptr = qemu_ram_ptr_length(raddr + base, plen);
+    if (is_write) {
+        /* the caller writes before address_space_unmap() */
+        fies_journal_write(raddr + base, *plen);
+    }
+    return ptr;
 }
 
 /* Unmaps a memory region previously mapped by address_space_map().
@@ -2406,6 +2730,7 @@ void stl_phys_notdirty(hwaddr addr, uint32_t val)
     } else {
         addr1 += memory_region_get_ram_addr(mr) & TARGET_PAGE_MASK;
         ptr = qemu_get_ram_ptr(addr1);
+        fies_journal_write(addr1, 4);
         stl_p(ptr, val);
 
         if (unlikely(in_migration)) {
@@ -2448,6 +2773,7 @@ static inline void stl_phys_internal(hwaddr addr, uint32_t val,
         /* RAM case */
         addr1 += memory_region_get_ram_addr(mr) & TARGET_PAGE_MASK;
         ptr = qemu_get_ram_ptr(addr1);
+        fies_journal_write(addr1, 4);
         switch (endian) {
         case DEVICE_LITTLE_ENDIAN:
             stl_le_p(ptr, val);
@@ -2513,6 +2839,7 @@ static inline void stw_phys_internal(hwaddr addr, uint32_t val,
         /* RAM case */
         addr1 += memory_region_get_ram_addr(mr) & TARGET_PAGE_MASK;
         ptr = qemu_get_ram_ptr(addr1);
+        fies_journal_write(addr1, 2);
         switch (endian) {
         case DEVICE_LITTLE_ENDIAN:
             stw_le_p(ptr, val);
@@ -0,0 +1,489 @@
+/*
+ * fault-injection-campaign.c
+ *
+ * Every experiment appends one fixed-schema outcome record per fault of
+ * the fault library to the campaign file, and one entry to the campaign
+ * index (<campaign>.idx). Parallel experiment processes may share the
+ * same campaign; appends are serialized with flock().
+ *
+ * The campaign file is tab separated text with the columns
+ *
+ *   experiment fault_id component target mode trigger type address mask
+ *   activations outcome insns latency
+ *
+ * where activations is the number of times the fault was injected, outcome
+ * is the class of the whole experiment, insns the number of executed guest
+ * instructions and latency the number of instructions between the first
+ * fault activation and the detection (-1 if the fault was not activated
+ * or not detected).
+ */
+
+#include "fault-injection-campaign.h"
+#include "fault-injection-library.h"
+#include "profiler.h"
+#include "include/monitor/monitor.h"
+#include "qemu/option.h"
+#include "qemu/bswap.h"
+#include "sysemu/sysemu.h"
+
+#include <sys/file.h>
+
+/**
+ * Semihosting SYS_EXIT reason of a regular application exit
+ * (ADP_Stopped_ApplicationExit). Any other reason, e.g. from abort(),
+ * is taken as detection of the fault by the application.
+ */
+#define FIES_ADP_STOPPED_APPLICATION_EXIT	0x20026
+
+static const char *fies_outcome_names[FIES_OUTCOME_MAX] = {
+	[FIES_OUTCOME_MASKED] = "masked",
+	[FIES_OUTCOME_DETECTED] = "detected",
+	[FIES_OUTCOME_SDC] = "sdc",
+	[FIES_OUTCOME_HANG] = "hang",
+	[FIES_OUTCOME_CRASH] = "crash",
+};
+
+uint64_t fies_campaign_insn_limit = UINT64_MAX;
+
+/**
+ * The campaign file and the experiment number given on the command line
+ * (-1 to append the experiment to the end of the index).
+ */
+static char *campaign_filename;
+static int64_t campaign_experiment = -1;
+
+/**
+ * State of the running experiment
+ */
+static int outcome = -1;
+static bool exception_after_activation;
+static bool first_activation_seen;
+static uint64_t first_activation_insn;
+static int64_t detection_latency = -1;
+
+/**
+ * Activation count per fault id
+ */
+static uint64_t *activations;
+static int activations_size;
+
+/**
+ * The diagnostic coverage per component, target and mode, aggregated from
+ * the campaign file. campaign_offset is the part of the file already read.
+ */
+typedef struct FiesCampaignClass
+{
+	char *component;
+	char *target;
+	char *mode;
+	uint64_t not_activated;
+	uint64_t count[FIES_OUTCOME_MAX];
+} FiesCampaignClass;
+
+static GHashTable *campaign_classes;
+static off_t campaign_offset;
+
+static const char *fies_campaign_outcome_name(int o)
+{
+	return o >= 0 && o < FIES_OUTCOME_MAX ? fies_outcome_names[o] : "unknown";
+}
+
+static int fies_campaign_outcome_from_name(const char *name)
+{
+	int i;
+
+	for (i = 0; i < FIES_OUTCOME_MAX; i++)
+		if (!strcmp(name, fies_outcome_names[i]))
+			return i;
+
+	return -1;
+}
+
+/**
+ * Decides the outcome of an experiment which did not end with a guest
+ * exit: a guest abort or undefined instruction after the fault was
+ * activated is a crash, everything else a hang.
+ */
+static FiesOutcome fies_campaign_final_outcome(void)
+{
+	if (outcome >= 0)
+		return outcome;
+
+	return exception_after_activation ? FIES_OUTCOME_CRASH : FIES_OUTCOME_HANG;
+}
+
+static int fies_campaign_write_all(int fd, const char *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0)
+	{
+		ret = write(fd, buf, len);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret <= 0)
+			return -1;
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+/**
+ * Appends the records of this experiment to the campaign file and its
+ * index. Registered with atexit(), so that it runs for guest exits,
+ * the instruction limit, 'quit' and SIGTERM alike.
+ */
+static void fies_campaign_finish(void)
+{
+	FiesCampaignIndexEntry entry;
+	GString *records;
+	FaultList *fault;
+	char *index_filename;
+	FiesOutcome final = fies_campaign_final_outcome();
+	int64_t experiment;
+	uint64_t fault_activations;
+	int i, num_faults, fd, index_fd;
+	off_t offset;
+	struct stat st;
+
+	fd = qemu_open(campaign_filename, O_WRONLY | O_APPEND | O_CREAT, 0644);
+	if (fd < 0)
+	{
+		fprintf(stderr, "fies: cannot open campaign file %s: %s\n",
+				campaign_filename, strerror(errno));
+		return;
+	}
+	index_filename = g_strdup_printf("%s.idx", campaign_filename);
+	index_fd = qemu_open(index_filename, O_RDWR | O_APPEND | O_CREAT, 0644);
+	g_free(index_filename);
+	if (index_fd < 0)
+	{
+		fprintf(stderr, "fies: cannot open campaign index: %s\n", strerror(errno));
+		close(fd);
+		return;
+	}
+
+	if (flock(fd, LOCK_EX) < 0 || fstat(index_fd, &st) < 0)
+	{
+		perror("fies: cannot lock campaign file");
+		goto out;
+	}
+
+	experiment = campaign_experiment;
+	if (experiment < 0)
+		experiment = st.st_size / sizeof(FiesCampaignIndexEntry);
+
+	records = g_string_new(NULL);
+	offset = lseek(fd, 0, SEEK_END);
+	if (offset == 0)
+	{
+		g_string_append(records, "# experiment\tfault_id\tcomponent\ttarget"
+						"\tmode\ttrigger\ttype\taddress\tmask\tactivations"
+						"\toutcome\tinsns\tlatency\n");
+		offset = records->len;
+	}
+
+	num_faults = getNumFaultListElements();
+	for (i = 0; i < num_faults; i++)
+	{
+		fault = getFaultListElement(i);
+		fault_activations = fault->id > 0 && fault->id <= activations_size ?
+				activations[fault->id - 1] : 0;
+		g_string_append_printf(records,
+				"%" PRId64 "\t%d\t%s\t%s\t%s\t%s\t%s\t0x%08x\t0x%08x\t%" PRIu64
+				"\t%s\t%" PRIu64 "\t%" PRId64 "\n",
+				experiment, fault->id, fault->component, fault->target,
+				fault->mode, fault->trigger ? fault->trigger : "-",
+				fault->type ? fault->type : "-",
+				(unsigned int) fault->params.address,
+				(unsigned int) fault->params.mask,
+				fault_activations, fies_campaign_outcome_name(final),
+				profile_insn_count, final == FIES_OUTCOME_DETECTED &&
+				fault_activations ? detection_latency : -1);
+	}
+
+	entry.offset = cpu_to_le64(offset);
+	entry.records = cpu_to_le32(num_faults);
+	entry.outcome = cpu_to_le32(final);
+
+	if (fies_campaign_write_all(fd, records->str, records->len) < 0 ||
+		fies_campaign_write_all(index_fd, (const char *) &entry, sizeof(entry)) < 0)
+		perror("fies: cannot write campaign record");
+
+	g_string_free(records, true);
+	flock(fd, LOCK_UN);
+out:
+	close(index_fd);
+	close(fd);
+}
+
+/**
+ * Parses the -fi-campaign option:
+ * file=<campaign file>[,insn-limit=<n>][,experiment=<n>]
+ *
+ * @param[in] optarg - the option argument
+ */
+void fies_campaign_parse_option(const char *optarg)
+{
+	char buf[1024];
+
+	if (!get_param_value(buf, sizeof(buf), "file", optarg))
+	{
+		fprintf(stderr, "-fi-campaign: file=<campaign file> is required\n");
+		exit(1);
+	}
+	campaign_filename = g_strdup(buf);
+
+	if (get_param_value(buf, sizeof(buf), "insn-limit", optarg))
+		fies_campaign_insn_limit = strtoull(buf, NULL, 0);
+
+	if (get_param_value(buf, sizeof(buf), "experiment", optarg))
+		campaign_experiment = strtoll(buf, NULL, 0);
+
+	atexit(fies_campaign_finish);
+}
+
+/**
+ * Counts the activation of a fault; called every time a fault is injected.
+ *
+ * @param[in] id - the id of the fault
+ */
+void fies_campaign_fault_activated(int id)
+{
+	int new_size;
+
+	if (!campaign_filename || id <= 0)
+		return;
+
+	if (id > activations_size)
+	{
+		new_size = MAX(id, activations_size * 2);
+		activations = g_renew(uint64_t, activations, new_size);
+		memset(activations + activations_size, 0,
+			   (new_size - activations_size) * sizeof(uint64_t));
+		activations_size = new_size;
+	}
+	activations[id - 1]++;
+
+	if (!first_activation_seen)
+	{
+		first_activation_seen = true;
+		first_activation_insn = profile_insn_count;
+	}
+}
+
+/**
+ * Notes that the guest took an undefined instruction or abort exception.
+ */
+void fies_campaign_guest_exception(void)
+{
+	if (first_activation_seen)
+		exception_after_activation = true;
+}
+
+/**
+ * Classifies the experiment when the guest exits through semihosting.
+ * A regular exit means the fault was masked (unless a result check
+ * already reported silent data corruption), any other exit reason means
+ * the application detected the fault.
+ *
+ * @param[in] reason - the SYS_EXIT reason code
+ */
+void fies_campaign_guest_exit(uint32_t reason)
+{
+	if (reason == FIES_ADP_STOPPED_APPLICATION_EXIT)
+	{
+		if (outcome < 0)
+			outcome = FIES_OUTCOME_MASKED;
+		return;
+	}
+
+	outcome = FIES_OUTCOME_DETECTED;
+	if (first_activation_seen)
+		detection_latency = profile_insn_count - first_activation_insn;
+}
+
+/**
+ * Sets the outcome of the running experiment, e.g. SDC from a check of
+ * the application results.
+ *
+ * @param[in] o - the outcome class
+ */
+void fies_campaign_set_outcome(FiesOutcome o)
+{
+	outcome = o;
+}
+
+/**
+ * Stops an experiment which ran into the instruction limit.
+ */
+void fies_campaign_limit_reached(void)
+{
+	qemu_system_shutdown_request();
+}
+
+static void fies_campaign_class_free(gpointer data)
+{
+	FiesCampaignClass *c = data;
+
+	g_free(c->component);
+	g_free(c->target);
+	g_free(c->mode);
+	g_free(c);
+}
+
+static void fies_campaign_stats_add(char **fields)
+{
+	FiesCampaignClass *c;
+	char *key;
+	int o;
+
+	o = fies_campaign_outcome_from_name(fields[10]);
+	if (o < 0)
+		return;
+
+	key = g_strdup_printf("%s\t%s\t%s", fields[2], fields[3], fields[4]);
+	c = g_hash_table_lookup(campaign_classes, key);
+	if (!c)
+	{
+		c = g_new0(FiesCampaignClass, 1);
+		c->component = g_strdup(fields[2]);
+		c->target = g_strdup(fields[3]);
+		c->mode = g_strdup(fields[4]);
+		g_hash_table_insert(campaign_classes, key, c);
+	}
+	else
+		g_free(key);
+
+	if (strtoull(fields[9], NULL, 0) == 0)
+		c->not_activated++;
+	else
+		c->count[o]++;
+}
+
+/**
+ * Reads the records appended to the campaign file since the last call.
+ * A partially written last line is left for the next call.
+ */
+static void fies_campaign_stats_update(void)
+{
+	char *line = NULL;
+	char **fields;
+	size_t size = 0;
+	ssize_t len;
+	FILE *f;
+
+	if (!campaign_classes)
+		campaign_classes = g_hash_table_new_full(g_str_hash, g_str_equal,
+												 g_free, fies_campaign_class_free);
+
+	f = fopen(campaign_filename, "r");
+	if (!f)
+		return;
+
+	if (fseeko(f, campaign_offset, SEEK_SET) == 0)
+	{
+		while ((len = getline(&line, &size, f)) > 0 && line[len - 1] == '\n')
+		{
+			campaign_offset += len;
+			if (line[0] == '#')
+				continue;
+
+			line[len - 1] = '\0';
+			fields = g_strsplit(line, "\t", 0);
+			if (g_strv_length(fields) == 13)
+				fies_campaign_stats_add(fields);
+			g_strfreev(fields);
+		}
+	}
+
+	free(line);
+	fclose(f);
+}
+
+static void fies_campaign_class_collect(gpointer key, gpointer value,
+										gpointer opaque)
+{
+	GList **classes = opaque;
+
+	*classes = g_list_prepend(*classes, value);
+}
+
+static gint fies_campaign_class_compare(gconstpointer a, gconstpointer b)
+{
+	const FiesCampaignClass *ca = a, *cb = b;
+	int ret;
+
+	ret = strcmp(ca->component, cb->component);
+	if (!ret)
+		ret = strcmp(ca->target, cb->target);
+	if (!ret)
+		ret = strcmp(ca->mode, cb->mode);
+
+	return ret;
+}
+
+/**
+ * Prints the outcome classes and the diagnostic coverage per component,
+ * target and mode of all experiments recorded so far. The diagnostic
+ * coverage is the share of activated, not masked faults which were
+ * detected.
+ *
+ * @param[in] mon - the monitor to print to
+ */
+void fies_campaign_stats_print(Monitor *mon)
+{
+	FiesCampaignClass *c;
+	GList *classes = NULL, *l;
+	uint64_t total[FIES_OUTCOME_MAX] = { 0 }, not_activated = 0;
+	uint64_t dangerous;
+	int i;
+
+	if (!campaign_filename)
+	{
+		monitor_printf(mon, "No fault injection campaign (see -fi-campaign)\n");
+		return;
+	}
+
+	fies_campaign_stats_update();
+
+	monitor_printf(mon, "%-10s %-24s %-12s %8s %8s %8s %8s %8s %8s %7s\n",
+				   "component", "target", "mode", "not act.", "masked",
+				   "detected", "sdc", "hang", "crash", "DC [%]");
+
+	g_hash_table_foreach(campaign_classes, fies_campaign_class_collect, &classes);
+	classes = g_list_sort(classes, fies_campaign_class_compare);
+	for (l = classes; l; l = l->next)
+	{
+		c = l->data;
+		dangerous = 0;
+		for (i = 0; i < FIES_OUTCOME_MAX; i++)
+		{
+			total[i] += c->count[i];
+			if (i != FIES_OUTCOME_MASKED)
+				dangerous += c->count[i];
+		}
+		not_activated += c->not_activated;
+
+		monitor_printf(mon, "%-10s %-24s %-12s %8" PRIu64 " %8" PRIu64 " %8" PRIu64
+					   " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %7.2f\n",
+					   c->component, c->target, c->mode, c->not_activated,
+					   c->count[FIES_OUTCOME_MASKED],
+					   c->count[FIES_OUTCOME_DETECTED],
+					   c->count[FIES_OUTCOME_SDC], c->count[FIES_OUTCOME_HANG],
+					   c->count[FIES_OUTCOME_CRASH],
+					   dangerous ? c->count[FIES_OUTCOME_DETECTED] * 100.0 / dangerous : 0.0);
+	}
+	g_list_free(classes);
+
+	dangerous = total[FIES_OUTCOME_DETECTED] + total[FIES_OUTCOME_SDC] +
+				total[FIES_OUTCOME_HANG] + total[FIES_OUTCOME_CRASH];
+	monitor_printf(mon, "%-48s %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64
+				   " %8" PRIu64 " %8" PRIu64 " %7.2f\n", "total", not_activated,
+				   total[FIES_OUTCOME_MASKED], total[FIES_OUTCOME_DETECTED],
+				   total[FIES_OUTCOME_SDC], total[FIES_OUTCOME_HANG],
+				   total[FIES_OUTCOME_CRASH],
+				   dangerous ? total[FIES_OUTCOME_DETECTED] * 100.0 / dangerous : 0.0);
+}
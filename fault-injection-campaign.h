@@ -0,0 +1,64 @@
+/*
+ * fault-injection-campaign.h
+ *
+ * Fixed-schema outcome records for fault injection campaigns and the
+ * on-line aggregation of their diagnostic coverage.
+ */
+
+#ifndef FAULT_INJECTION_CAMPAIGN_H_
+#define FAULT_INJECTION_CAMPAIGN_H_
+
+#include "qemu-common.h"
+
+/**
+ * The outcome class of one experiment
+ */
+typedef enum
+{
+	FIES_OUTCOME_MASKED,
+	FIES_OUTCOME_DETECTED,
+	FIES_OUTCOME_SDC,
+	FIES_OUTCOME_HANG,
+	FIES_OUTCOME_CRASH,
+	FIES_OUTCOME_MAX
+} FiesOutcome;
+
+/**
+ * One entry of the campaign index file (<campaign>.idx), little endian.
+ * Entry n describes experiment n of the campaign file.
+ */
+typedef struct FiesCampaignIndexEntry
+{
+	uint64_t offset;	/* file offset of the first record */
+	uint32_t records;	/* number of records (one per fault) */
+	uint32_t outcome;	/* FiesOutcome of the experiment */
+} FiesCampaignIndexEntry;
+
+/**
+ * see corresponding c-file for documentation
+ */
+void fies_campaign_parse_option(const char *optarg);
+void fies_campaign_fault_activated(int id);
+void fies_campaign_guest_exception(void);
+void fies_campaign_guest_exit(uint32_t reason);
+void fies_campaign_set_outcome(FiesOutcome outcome);
+void fies_campaign_limit_reached(void);
+void fies_campaign_stats_print(Monitor *mon);
+
+/**
+ * The number of guest instructions after which an experiment is stopped
+ * and classified as hang (or crash), or UINT64_MAX for no limit.
+ */
+extern uint64_t fies_campaign_insn_limit;
+
+/**
+ * Called with the number of executed guest instructions after every
+ * instruction.
+ */
+static inline void fies_campaign_check_limit(uint64_t insns)
+{
+	if (unlikely(insns == fies_campaign_insn_limit))
+		fies_campaign_limit_reached();
+}
+
+#endif /* FAULT_INJECTION_CAMPAIGN_H_ */
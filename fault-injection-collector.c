@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include "fault-injection-collector.h"
+#include "fault-injection-profile.h"
 
 /**
  * The file, where the data collector writes
@@ -28,8 +29,11 @@
   */
 void data_collector_write(const char* buf)
 {
+    FiesProfileScope scope;
+
     if (do_fault_injection)
     {
+    	fies_profile_start(&scope);
  	    data_collector = fopen("fies.log", "a+");
     	if (data_collector == NULL)
        	{
@@ -38,6 +42,7 @@ void data_collector_write(const char* buf)
     	}
     	fprintf(data_collector,  "%s\n", (const uint8_t *) buf);
     	fclose(data_collector);
+    	fies_profile_end(&scope, FIES_PROF_COLLECTOR);
     }
 }
 
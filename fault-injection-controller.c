@@ -10,6 +10,7 @@
 #include "fault-injection-data-analyzer.h"
 #include "fault-injection-config.h"
 #include "profiler.h"
+#include "fault-injection-profile.h"
 
 #include "qemu/timer.h"
 #include "include/monitor/monitor.h"
@@ -192,6 +193,203 @@ void fault_injection_controller_initTimer(void)
 	timer_value = qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL);
 }
 
+/**
+ * Sorted list of the guest pages, which hold the address or
+ * coupling address of a RAM fault. Accesses to these pages are
+ * kept on the softmmu slow path (TLB_FAULT), all other pages use
+ * the inline TLB hit path of the generated code.
+ */
+static target_ulong *armed_pages;
+static int num_armed_pages;
+
+static int compare_pages(const void *a, const void *b)
+{
+	target_ulong pa = *(const target_ulong *)a;
+	target_ulong pb = *(const target_ulong *)b;
+
+	return pa < pb ? -1 : pa > pb;
+}
+
+static void arm_page(int address)
+{
+	if (address == -1)
+		return;
+
+	armed_pages[num_armed_pages++] = (target_ulong)address & TARGET_PAGE_MASK;
+}
+
+/**
+ * Rebuilds the list of armed pages from the fault list and flushes
+ * the TLBs of all CPUs, so that new TLB entries get the TLB_FAULT
+ * flag. Has to be called whenever the fault list changes.
+ */
+void fault_injection_controller_arm_pages(void)
+{
+	FaultList *fault;
+	CPUState *cpu;
+	int element, n, i;
+
+	n = getNumFaultListElements();
+	g_free(armed_pages);
+	armed_pages = g_new(target_ulong, 2 * n);
+	num_armed_pages = 0;
+
+	for (element = 0; element < n; element++)
+	{
+		fault = getFaultListElement(element);
+
+		if (!fault->component || strcmp(fault->component, "RAM"))
+			continue;
+
+		arm_page(fault->params.address);
+		arm_page(fault->params.cf_address);
+	}
+
+	qsort(armed_pages, num_armed_pages, sizeof(target_ulong), compare_pages);
+	for (i = 1, n = 0; i < num_armed_pages; i++)
+	{
+		if (armed_pages[i] != armed_pages[n])
+			armed_pages[++n] = armed_pages[i];
+	}
+	if (num_armed_pages)
+		num_armed_pages = n + 1;
+
+	CPU_FOREACH(cpu)
+	{
+		tlb_flush(cpu->env_ptr, 1);
+	}
+}
+
+/**
+ * Set if a loaded fault can read or modify the condition flags
+ * between two guest instructions.
+ */
+static bool flags_observed;
+
+/**
+ * Set if a loaded fault can read or modify the CPU registers from
+ * the fault injection hooks.
+ */
+static bool regs_observed;
+
+/**
+ * Registers (bit n = register n), whose accesses need the register
+ * hooks, because an access-triggered register fault names them.
+ */
+static uint32_t reg_hooks;
+
+/**
+ * Checks, which parts of the CPU state the loaded faults can access:
+ * CPU faults (condition flags, or instruction faults, which change the
+ * instruction after the translator has analysed it) and register faults.
+ * Translated code depends on the result, so the translation cache is
+ * flushed whenever it changes. If only the hooked registers change,
+ * just the blocks accessing the affected registers are invalidated.
+ */
+void fault_injection_controller_check_cpu_faults(void)
+{
+	FaultList *fault;
+	bool flags = false, regs = false;
+	uint32_t hooks = 0;
+	int element;
+
+	for (element = 0; element < getNumFaultListElements(); element++)
+	{
+		fault = getFaultListElement(element);
+
+		if (!fault->component)
+			continue;
+
+		if (!strcmp(fault->component, "CPU"))
+		{
+			flags = true;
+			regs = true;
+		}
+		else if (!strcmp(fault->component, "REGISTER"))
+		{
+			regs = true;
+			/* register number 16 and above is the CPSR */
+			if (!fault->target || strcmp(fault->target, "REGISTER CELL")
+				|| fault->params.address < 0 || fault->params.address > 15
+				|| fault->params.cf_address > 15)
+				flags = true;
+
+			/* time and PC triggered faults do not use the access hooks */
+			if (!fault->target || !fault->trigger
+				|| !strcmp(fault->trigger, "TIME")
+				|| !strcmp(fault->trigger, "PC"))
+				continue;
+
+			/* a decoder fault redirects the access to any register */
+			if (!strcmp(fault->target, "ADDRESS DECODER"))
+				hooks = 0xffff;
+			else if (!strcmp(fault->target, "REGISTER CELL"))
+			{
+				if (fault->params.address >= 0 && fault->params.address <= 15)
+					hooks |= 1 << fault->params.address;
+				if (fault->params.cf_address >= 0 && fault->params.cf_address <= 15)
+					hooks |= 1 << fault->params.cf_address;
+			}
+		}
+	}
+
+	if ((flags != flags_observed || regs != regs_observed) && first_cpu)
+		tb_flush(first_cpu->env_ptr);
+	else if (hooks != reg_hooks && first_cpu && !profile_registers)
+		tb_invalidate_regs(hooks ^ reg_hooks);
+
+	flags_observed = flags;
+	regs_observed = regs;
+	reg_hooks = hooks;
+}
+
+/**
+ * Returns true if the condition flags have to be up to date
+ * in the CPU state at every fault injection hook.
+ */
+bool fault_injection_controller_flags_observed(void)
+{
+	return flags_observed;
+}
+
+/**
+ * Returns true if the fault injection hooks can read or write the
+ * CPU registers, i.e. they have to be called with the registers
+ * stored in the CPU state.
+ */
+bool fault_injection_controller_regs_observed(void)
+{
+	return regs_observed;
+}
+
+/**
+ * Returns the registers (bit n = register n), whose loads and stores
+ * have to call the register hooks. With -profiling r these are all
+ * registers, otherwise only the ones named by an access-triggered
+ * register fault.
+ */
+uint32_t fault_injection_controller_reg_hooks(void)
+{
+	return profile_registers ? 0xffff : reg_hooks;
+}
+
+/**
+ * Checks if a guest page holds the address of a RAM fault.
+ *
+ * @param[in] vaddr - the virtual address of the page.
+ * @param[out] - true if accesses to the page have to call the controller.
+ */
+bool fault_injection_controller_page_armed(target_ulong vaddr)
+{
+	target_ulong page = vaddr & TARGET_PAGE_MASK;
+
+	if (!num_armed_pages)
+		return false;
+
+	return bsearch(&page, armed_pages, num_armed_pages,
+				   sizeof(target_ulong), compare_pages) != NULL;
+}
+
 /**
  * Normalizes the timer value to a uniform value (ns).
  *
@@ -240,6 +438,65 @@ static void time_normalization(FaultList *fault, int64_t *start_time,
 	}
 }
 
+/**
+ * Returns the virtual time until the next start-, stop- or interval-boundary
+ * of a transient or intermittend fault, i.e. how far QEMU_CLOCK_VIRTUAL can be
+ * warped forward without skipping the activation or deactivation of a fault.
+ *
+ * @param[out] - the time in ns, or -1 if no time window is pending
+ */
+int64_t fault_injection_controller_next_deadline(void)
+{
+	int element;
+	FaultList *fault;
+	int64_t start_time = 0, stop_time = 0, interval = 0;
+	int64_t current_timer_value, next, deadline = -1;
+
+	current_timer_value = fault_injection_controller_getTimer();
+
+	for (element = 0; element < getNumFaultListElements(); element++)
+	{
+		fault = getFaultListElement(element);
+
+		if (!fault->type || !fault->timer || !fault->duration)
+			continue;
+
+		if (!strcmp(fault->type, "TRANSIENT"))
+		{
+			time_normalization(fault, &start_time, &stop_time, NULL);
+			interval = 0;
+		}
+		else if (!strcmp(fault->type, "INTERMITTEND") && fault->interval)
+		{
+			time_normalization(fault, &start_time, &stop_time, &interval);
+		}
+		else
+		{
+			continue;
+		}
+
+		if (current_timer_value >= stop_time)
+			continue;
+
+		if (current_timer_value < start_time)
+			next = start_time;
+		else if (interval > 0)
+			next = MIN((current_timer_value / interval + 1) * interval,
+						stop_time);
+		else
+			next = stop_time;
+
+		/*
+		 * the windows are open intervals, so landing exactly on the
+		 * boundary does not skip over it
+		 */
+		if (deadline < 0 || next - current_timer_value < deadline)
+			deadline = next - current_timer_value;
+	}
+
+	return deadline;
+}
+
 /**
  * Sets bit-flip faults active for the different triggering-methods, extract the necessary
  * information (e.g. set bits in the fault mask), calls the appropriate functions in the
@@ -842,13 +1099,6 @@ static void fault_injection_controller_memory_address(CPUArchState *env, hwaddr
     {
     	fault = getFaultListElement(element);
 
-		#if defined(DEBUG_FAULT_CONTROLLER_TLB_FLUSH)
-			printf("flushing tlb address %x\n", (int)*addr);
-		#endif
-		tlb_flush_page(env, (target_ulong)*addr);
-
-		
-
 		/*
 		 * accessed address is not the defined fault address or the trigger is set to
 		 * time- or pc-triggering.
@@ -3963,11 +4213,6 @@ static void fault_injection_controller_memory_content(CPUArchState *env, hwaddr
     		continue;
     	}
 
-		#if defined(DEBUG_FAULT_CONTROLLER_TLB_FLUSH)
-			printf("flushing tlb address %x\n", (int)*addr);
-		#endif
-		tlb_flush_page(env, (target_ulong)*addr);
-
     	/*
     	 * strcmp does not check a null-pointer - system will crash
     	 * in the case of a null-pointer.
@@ -5055,15 +5300,13 @@ void start_automatic_test_process(CPUArchState *env)
  * @param[in] access_type - if the access-operation is a write, read or execute.
  *
  */
-void fault_injection_controller_init(CPUArchState *env, hwaddr *addr,
+static void fault_injection_controller_dispatch(CPUArchState *env, hwaddr *addr,
 												uint32_t *value, InjectionMode injection_mode,
 												AccessType access_type)
 {
     FaultList *fault;
     int element = 0;
 
-    profiler_log(env, addr, value, access_type);
-
 	if (*addr == address_in_use)
 		return;
 
@@ -5125,6 +5368,56 @@ void fault_injection_controller_init(CPUArchState *env, hwaddr *addr,
 		fprintf(stderr, "Unknown fault injection target!\n");
 }
 
+/**
+ * Maps a hook invocation to its site for the FIES profiler.
+ */
+static FiesProfileSite fault_injection_profile_site(InjectionMode injection_mode,
+													AccessType access_type)
+{
+	switch (injection_mode)
+	{
+	case FI_MEMORY_ADDR:
+		return FIES_PROF_MEMORY_ADDR;
+	case FI_MEMORY_CONTENT:
+		return FIES_PROF_MEMORY_CONTENT;
+	case FI_REGISTER_ADDR:
+		return FIES_PROF_REGISTER_DECODER;
+	case FI_REGISTER_CONTENT:
+		return access_type == write_access_type ?
+				FIES_PROF_REGISTER_STORE : FIES_PROF_REGISTER_LOAD;
+	case FI_INSN:
+		return FIES_PROF_INSN;
+	default:
+		return FIES_PROF_TIME;
+	}
+}
+
+/**
+ * Entry point of all fault injection hooks (memory, register, instruction
+ * and time). Logs the access for the profiler and calls the appropriate
+ * controller function for the injection mode.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] addr - the address or the buffer, where the fault is injected.
+ * @param[in] value - the value, which is read or written (may be NULL).
+ * @param[in] injection_mode - the hook site.
+ * @param[in] access_type - read, write or execution access.
+ */
+void fault_injection_controller_init(CPUArchState *env, hwaddr *addr,
+												uint32_t *value, InjectionMode injection_mode,
+												AccessType access_type)
+{
+	FiesProfileScope scope;
+
+	fies_profile_start(&scope);
+	profiler_log(env, addr, value, access_type);
+	fies_profile_end(&scope, FIES_PROF_PROFILER);
+
+	fies_profile_start(&scope);
+	fault_injection_controller_dispatch(env, addr, value, injection_mode, access_type);
+	fies_profile_end(&scope, fault_injection_profile_site(injection_mode, access_type));
+}
+
 void setMonitor(Monitor *mon)
 {
 	qemu_serial_monitor = mon;
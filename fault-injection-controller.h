@@ -49,7 +49,14 @@ void fault_injection_controller_init(CPUArchState *env, hwaddr *addr,
 												uint32_t *value, InjectionMode injection_mode,
 												AccessType access_type);
 int64_t fault_injection_controller_getTimer(void);
+int64_t fault_injection_controller_next_deadline(void);
 void fault_injection_controller_initTimer(void);
+void fault_injection_controller_arm_pages(void);
+bool fault_injection_controller_page_armed(target_ulong vaddr);
+void fault_injection_controller_check_cpu_faults(void);
+bool fault_injection_controller_flags_observed(void);
+bool fault_injection_controller_regs_observed(void);
+uint32_t fault_injection_controller_reg_hooks(void);
 void init_ops_on_cell(int size);
 void destroy_ops_on_cell(void);
 int ends_with(const char *string, const char *ending);
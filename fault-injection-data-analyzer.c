@@ -7,6 +7,7 @@
 #include "fault-injection-data-analyzer.h"
 #include "fault-injection-controller.h"
 #include "fault-injection-config.h"
+#include "fault-injection-campaign.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -43,6 +44,8 @@
   */
 void incr_num_injected_faults(int id, const char* fault_type)
 {
+	fies_campaign_fault_activated(id);
+
 	id -= 1;
 
 	if (id_array[id])
@@ -0,0 +1,199 @@
+/*
+ * fault-injection-journal.c
+ *
+ * With -fi-journal the device and CPU state is saved to memory when the
+ * machine is ready to run, and from then on the original contents of
+ * every page of guest RAM are saved before the page is written for the
+ * first time. This covers the cells that FIES writes (permanent memory
+ * faults, transient faults stored by the guest) as well as everything the
+ * guest and its devices write in the course of an experiment.
+ *
+ * Whether a page has been saved is kept in the JOURNAL_DIRTY_FLAG of the
+ * RAM dirty bitmap: pages without it are mapped "not dirty" in the TLB,
+ * so that the first store of the guest goes through notdirty_mem_write().
+ *
+ * fault-rollback writes the saved pages back and loads the saved device
+ * state, which takes time in the number of pages written since the last
+ * rollback. The saved pages are kept for the next experiment. Like a
+ * reset, the rollback ends a shutdown (see -no-shutdown), so that the next
+ * experiment can be started with "cont".
+ */
+
+#include "fault-injection-journal.h"
+#include "profiler.h"
+#include "cpu.h"
+#include "exec/exec-all.h"
+#include "exec/memory.h"
+#include "exec/memory-internal.h"
+#include "sysemu/sysemu.h"
+#include "qmp-commands.h"
+
+/**
+ * One saved page of guest RAM
+ */
+typedef struct FiesJournalPage
+{
+	ram_addr_t addr;
+	uint8_t *data;
+} FiesJournalPage;
+
+bool fies_journal_active;
+
+/**
+ * The saved pages. Entries past journal_len keep their buffers from
+ * earlier experiments for reuse.
+ */
+static FiesJournalPage *journal;
+static unsigned journal_len;
+static unsigned journal_size;
+
+/**
+ * The device and CPU state, and the instruction count, at the start of
+ * the journal
+ */
+static GByteArray *journal_state;
+static uint64_t journal_insn_count;
+
+/**
+ * Clear the journal flag of all RAM pages, so that every page is saved
+ * again before it is written.
+ */
+static void fies_journal_reset_pages(void)
+{
+	RAMBlock *block;
+
+	QTAILQ_FOREACH(block, &ram_list.blocks, next)
+		cpu_physical_memory_reset_dirty(block->offset,
+				block->offset + block->length, JOURNAL_DIRTY_FLAG);
+}
+
+/**
+ * Save the device and CPU state and start recording the pages written
+ * to guest RAM. Called once the machine has been reset, or the -loadvm
+ * snapshot has been loaded.
+ */
+void fies_journal_start(void)
+{
+	int saved_vm_running;
+
+	saved_vm_running = runstate_is_running();
+	vm_stop(RUN_STATE_SAVE_VM);
+
+	journal_state = qemu_save_device_state_mem();
+	if (!journal_state)
+	{
+		fprintf(stderr, "-fi-journal: cannot save the device state\n");
+		exit(1);
+	}
+	journal_insn_count = profile_insn_count;
+
+	fies_journal_reset_pages();
+	fies_journal_active = true;
+
+	if (saved_vm_running)
+		vm_start();
+}
+
+/**
+ * Save the pages in [addr, addr + length) that have not been saved since
+ * the last rollback.
+ */
+void fies_journal_record(ram_addr_t addr, ram_addr_t length)
+{
+	ram_addr_t page, end;
+	FiesJournalPage *p;
+
+	end = TARGET_PAGE_ALIGN(addr + length);
+	for (page = addr & TARGET_PAGE_MASK; page < end; page += TARGET_PAGE_SIZE)
+	{
+		if (cpu_physical_memory_get_dirty_flags(page) & JOURNAL_DIRTY_FLAG)
+			continue;
+
+		if (journal_len == journal_size)
+		{
+			journal_size = journal_size ? journal_size * 2 : 256;
+			journal = g_renew(FiesJournalPage, journal, journal_size);
+			memset(journal + journal_len, 0,
+					(journal_size - journal_len) * sizeof(*journal));
+		}
+
+		p = &journal[journal_len++];
+		if (!p->data)
+			p->data = g_malloc(TARGET_PAGE_SIZE);
+		p->addr = page;
+		memcpy(p->data, qemu_get_ram_ptr(page), TARGET_PAGE_SIZE);
+
+		cpu_physical_memory_set_dirty_flags(page, JOURNAL_DIRTY_FLAG);
+	}
+}
+
+/**
+ * Whether the machine can be stopped with RUN_STATE_INTERNAL_ERROR if its
+ * device state cannot be restored
+ */
+static bool fies_journal_can_rollback(void)
+{
+	return runstate_is_running() || runstate_needs_reset() ||
+			runstate_check(RUN_STATE_PAUSED) ||
+			runstate_check(RUN_STATE_PRELAUNCH) ||
+			runstate_check(RUN_STATE_DEBUG);
+}
+
+/**
+ * Restore guest RAM, the device and CPU state and the instruction count
+ * saved at the start of the journal.
+ */
+void qmp_fault_rollback(Error **errp)
+{
+	int saved_vm_running;
+	CPUState *cpu;
+	unsigned i;
+	int ret;
+
+	if (!journal_state)
+	{
+		error_setg(errp, "The fault journal is not enabled (see -fi-journal)");
+		return;
+	}
+	if (!fies_journal_can_rollback())
+	{
+		error_setg(errp, "The machine cannot be rolled back in its current state");
+		return;
+	}
+
+	saved_vm_running = runstate_is_running();
+	vm_stop(RUN_STATE_RESTORE_VM);
+
+	for (i = 0; i < journal_len; i++)
+	{
+		FiesJournalPage *p = &journal[i];
+
+		memcpy(qemu_get_ram_ptr(p->addr), p->data, TARGET_PAGE_SIZE);
+		tb_invalidate_phys_page_range(p->addr, p->addr + TARGET_PAGE_SIZE, 0);
+		cpu_physical_memory_clear_dirty_flags(p->addr, JOURNAL_DIRTY_FLAG);
+	}
+	journal_len = 0;
+
+	/* The restored pages must trap on their next write again */
+	CPU_FOREACH(cpu)
+		tlb_flush(cpu->env_ptr, 1);
+
+	profile_insn_count = journal_insn_count;
+
+	ret = qemu_load_device_state_mem(journal_state);
+	if (ret < 0)
+	{
+		/* Some devices have been restored and some not. Keep the machine
+		 * stopped until it is reset, as after an internal error. */
+		error_setg(errp, "Error %d while restoring the device state, "
+				"the machine has to be reset", ret);
+		if (!runstate_needs_reset())
+			runstate_set(RUN_STATE_INTERNAL_ERROR);
+		return;
+	}
+
+	if (runstate_needs_reset())
+		runstate_set(RUN_STATE_PAUSED);
+	if (saved_vm_running)
+		vm_start();
+}
@@ -0,0 +1,34 @@
+/*
+ * fault-injection-journal.h
+ *
+ * Undo journal of guest RAM and device state, used to run consecutive
+ * fault injection experiments in one process.
+ */
+
+#ifndef FAULT_INJECTION_JOURNAL_H_
+#define FAULT_INJECTION_JOURNAL_H_
+
+#include "qemu-common.h"
+#include "exec/cpu-common.h"
+
+/**
+ * see corresponding c-file for documentation
+ */
+void fies_journal_start(void);
+void fies_journal_record(ram_addr_t addr, ram_addr_t length);
+
+/**
+ * Set while the journal records the pages written to guest RAM.
+ */
+extern bool fies_journal_active;
+
+/**
+ * Called before length bytes of guest RAM at addr are written.
+ */
+static inline void fies_journal_write(ram_addr_t addr, ram_addr_t length)
+{
+	if (unlikely(fies_journal_active))
+		fies_journal_record(addr, length);
+}
+
+#endif /* FAULT_INJECTION_JOURNAL_H_ */
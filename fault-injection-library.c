@@ -635,6 +635,8 @@ void qmp_fault_reload(Monitor *mon, const char *filename, Error **errp)
     max_id = getMaxIDInFaultList();
     init_id_array(max_id);
     init_ops_on_cell(max_id);
+    fault_injection_controller_arm_pages();
+    fault_injection_controller_check_cpu_faults();
 
     xmlCleanupParser();
 }
@@ -0,0 +1,94 @@
+/*
+ * fault-injection-profile.c
+ *
+ * Call and cycle accounting for the FIES hook sites.
+ */
+
+#include "fault-injection-profile.h"
+
+#ifdef CONFIG_FIES_PROFILER
+
+uint64_t fies_profile_calls[FIES_PROF_MAX];
+int64_t fies_profile_cycles[FIES_PROF_MAX];
+int64_t fies_profile_nested;
+
+/**
+ * Cycle counter value when profiling started
+ */
+static int64_t fies_profile_start_time;
+
+static const char *fies_profile_names[FIES_PROF_MAX] = {
+	[FIES_PROF_MEMORY_CONTENT] = "memory content",
+	[FIES_PROF_MEMORY_ADDR] = "memory address",
+	[FIES_PROF_REGISTER_DECODER] = "register decoder",
+	[FIES_PROF_REGISTER_LOAD] = "register load",
+	[FIES_PROF_REGISTER_STORE] = "register store",
+	[FIES_PROF_INSN] = "insn",
+	[FIES_PROF_TIME] = "time",
+	[FIES_PROF_COLLECTOR] = "collector writes",
+	[FIES_PROF_PROFILER] = "profiler writes",
+	[FIES_PROF_TRANSLATION] = "translation",
+};
+
+static void fies_profile_exit(void)
+{
+	fies_profile_dump(stderr, fprintf);
+}
+
+/**
+ * Starts the accounting and arranges for the results to be printed
+ * to stderr when QEMU exits.
+ */
+void fies_profile_init(void)
+{
+	fies_profile_start_time = cpu_get_real_ticks();
+	atexit(fies_profile_exit);
+}
+
+/**
+ * Prints calls, cycles and share of the total run time per hook site.
+ * Whatever is not attributed to a site is guest execution, device
+ * emulation and the main loop.
+ *
+ * @param[in] f - the output stream
+ * @param[in] cpu_fprintf - the print function for the stream
+ */
+void fies_profile_dump(FILE *f, fprintf_function cpu_fprintf)
+{
+	int64_t total = cpu_get_real_ticks() - fies_profile_start_time;
+	int64_t hooks = 0;
+	int i;
+
+	if (total <= 0)
+		total = 1;
+
+	cpu_fprintf(f, "%-18s %14s %16s %10s %7s\n",
+				"site", "calls", "cycles", "cyc/call", "%");
+	for (i = 0; i < FIES_PROF_MAX; i++)
+	{
+		hooks += fies_profile_cycles[i];
+		cpu_fprintf(f, "%-18s %14" PRIu64 " %16" PRId64 " %10.1f %6.2f%%\n",
+					fies_profile_names[i], fies_profile_calls[i],
+					fies_profile_cycles[i],
+					fies_profile_calls[i] ?
+					(double)fies_profile_cycles[i] / fies_profile_calls[i] : 0,
+					(double)fies_profile_cycles[i] / total * 100.0);
+	}
+	cpu_fprintf(f, "%-18s %14s %16" PRId64 " %10s %6.2f%%\n",
+				"other", "", total - hooks, "",
+				(double)(total - hooks) / total * 100.0);
+	cpu_fprintf(f, "%-18s %14s %16" PRId64 "\n", "total", "", total);
+}
+
+#else
+
+void fies_profile_init(void)
+{
+}
+
+void fies_profile_dump(FILE *f, fprintf_function cpu_fprintf)
+{
+	cpu_fprintf(f, "FIES profiler not compiled\n");
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * fault-injection-profile.h
+ *
+ * Optional call and cycle accounting for the FIES hook sites, in the
+ * spirit of CONFIG_PROFILER. Enabled with "configure --enable-fies-profiler";
+ * otherwise all accounting compiles to nothing.
+ */
+
+#ifndef FAULT_INJECTION_PROFILE_H_
+#define FAULT_INJECTION_PROFILE_H_
+
+#include "qemu-common.h"
+#include "qemu/timer.h"
+
+/**
+ * The instrumented hook sites
+ */
+typedef enum
+{
+	FIES_PROF_MEMORY_CONTENT,
+	FIES_PROF_MEMORY_ADDR,
+	FIES_PROF_REGISTER_DECODER,
+	FIES_PROF_REGISTER_LOAD,
+	FIES_PROF_REGISTER_STORE,
+	FIES_PROF_INSN,
+	FIES_PROF_TIME,
+	FIES_PROF_COLLECTOR,
+	FIES_PROF_PROFILER,
+	FIES_PROF_TRANSLATION,
+	FIES_PROF_MAX
+} FiesProfileSite;
+
+/**
+ * State of one measurement. Sites may nest (e.g. the collector is called
+ * from within the controller), so each site is charged only for the cycles
+ * not spent in nested sites.
+ */
+typedef struct FiesProfileScope
+{
+	int64_t start;
+	int64_t nested;
+} FiesProfileScope;
+
+#ifdef CONFIG_FIES_PROFILER
+extern uint64_t fies_profile_calls[FIES_PROF_MAX];
+extern int64_t fies_profile_cycles[FIES_PROF_MAX];
+extern int64_t fies_profile_nested;
+
+static inline void fies_profile_start(FiesProfileScope *scope)
+{
+	scope->nested = fies_profile_nested;
+	fies_profile_nested = 0;
+	scope->start = cpu_get_real_ticks();
+}
+
+static inline void fies_profile_end(FiesProfileScope *scope,
+									FiesProfileSite site)
+{
+	int64_t delta = cpu_get_real_ticks() - scope->start;
+
+	fies_profile_calls[site]++;
+	fies_profile_cycles[site] += delta - fies_profile_nested;
+	fies_profile_nested = scope->nested + delta;
+}
+#else
+static inline void fies_profile_start(FiesProfileScope *scope)
+{
+}
+
+static inline void fies_profile_end(FiesProfileScope *scope,
+									FiesProfileSite site)
+{
+}
+#endif
+
+/**
+ * see corresponding c-file for documentation
+ */
+void fies_profile_init(void);
+void fies_profile_dump(FILE *f, fprintf_function cpu_fprintf);
+
+#endif /* FAULT_INJECTION_PROFILE_H_ */
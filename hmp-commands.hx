@@ -408,6 +408,21 @@ STEXI
 @item fault_reload @var{file}
 @findex fault_reload
 load the config file from @var{file}.
+ETEXI
+
+    {
+        .name       = "fault_rollback",
+        .args_type  = "",
+        .params     = "",
+        .help       = "restore the state saved by -fi-journal",
+        .mhandler.cmd = hmp_fault_rollback,
+    },
+
+STEXI
+@item fault_rollback
+@findex fault_rollback
+Restore guest RAM, the device and the CPU state saved by @option{-fi-journal}.
+A machine that has shut down is paused afterwards.
 ETEXI
 
     {
@@ -1724,6 +1739,8 @@ show roms
 show the TPM device
 @item info faults
 show all injected fault
+@item info fies-profile
+show FIES hook profiling information (calls and cycles per hook site)
 @end table
 ETEXI
 
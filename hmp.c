@@ -28,6 +28,7 @@
 #include "fault-injection-data-analyzer.h"
 #include "fault-injection-library.h"
 #include "fault-injection-config.h"
+#include "fault-injection-campaign.h"
 
 static void hmp_handle_error(Monitor *mon, Error **errp)
 {
@@ -80,23 +81,17 @@ void hmp_fault_reload(Monitor *mon, const QDict *qdict)
       free(fault_library_name);
 }
 
-void hmp_info_faults(Monitor *mon, const QDict *qdict)
+void hmp_fault_rollback(Monitor *mon, const QDict *qdict)
 {
-	FaultInfoList *fault_list = NULL, *fault = NULL;
-	int total_num_injected_faults = 0, total_num_detected_faults = 0;
-	float dc_total = 0.0f;
+    Error *errp = NULL;
 
-	int total_num_injected_faults_ram_trans = 0, total_num_injected_faults_ram_perm = 0;
-	int total_num_injected_faults_cpu_trans = 0, total_num_injected_faults_cpu_perm = 0;
-	int total_num_injected_faults_register_trans = 0, total_num_injected_faults_register_perm = 0;
+    qmp_fault_rollback(&errp);
+    hmp_handle_error(mon, &errp);
+}
 
-//	int total_num_detected_faults_ram_trans = 0, total_num_detected_faults_ram_perm = 0;
-//	int total_num_detected_faults_cpu_trans = 0, total_num_detected_faults_cpu_perm = 0;
-//	int total_num_detected_faults_register_trans = 0, total_num_detected_faults_register_perm = 0;
-//
-//	float dc_ram_trans = 0.0f, dc_ram_perm= 0.0f;
-//	float dc_cpu_trans = 0.0f, dc_cpu_perm= 0.0f;
-//	float dc_register_trans = 0.0f, dc_register_perm= 0.0f;
+void hmp_info_faults(Monitor *mon, const QDict *qdict)
+{
+	FaultInfoList *fault_list = NULL, *fault = NULL;
 
 	fault_list = qmp_query_faults(NULL);
 
@@ -150,83 +145,7 @@ void hmp_info_faults(Monitor *mon, const QDict *qdict)
     	return;
 
 	monitor_printf(mon, "\n------------------------------Statistics----------------------------------------\n");
-
-
-	total_num_injected_faults_ram_trans = get_num_injected_faults_ram_trans();
-	total_num_injected_faults_ram_perm = get_num_injected_faults_ram_perm();
-
-	total_num_injected_faults_cpu_trans = get_num_injected_faults_cpu_trans();
-	total_num_injected_faults_cpu_perm = get_num_injected_faults_cpu_perm();
-
-	total_num_injected_faults_register_trans = get_num_injected_faults_register_trans();
-	total_num_injected_faults_register_perm = get_num_injected_faults_register_perm();
-
-	monitor_printf(mon, "Injected faults: \t\t | Number: \n");
-	monitor_printf(mon, "RAM permanent \t\t\t | %d \n", total_num_injected_faults_ram_perm);
-	monitor_printf(mon, "RAM transient \t\t\t | %d \n", total_num_injected_faults_ram_trans);
-	monitor_printf(mon, "CPU permanent \t\t\t | %d \n", total_num_injected_faults_cpu_perm);
-	monitor_printf(mon, "CPU transient \t\t\t | %d \n", total_num_injected_faults_cpu_trans);
-	monitor_printf(mon, "Register permanent \t\t | %d \n", total_num_injected_faults_register_perm);
-	monitor_printf(mon, "Register transient \t\t | %d \n", total_num_injected_faults_register_trans);
-
-	monitor_printf(mon, "--------------------------------------------------------------------------------\n");
-
-//	total_num_detected_faults_ram_perm = get_num_detected_faults_ram_perm();
-//	total_num_detected_faults_ram_trans = get_num_detected_faults_ram_trans();
-//
-//	total_num_detected_faults_cpu_perm = get_num_detected_faults_cpu_perm();
-//	total_num_detected_faults_cpu_trans = get_num_detected_faults_cpu_trans();
-//
-//	total_num_detected_faults_register_perm = get_num_detected_faults_register_perm();
-//	total_num_detected_faults_register_trans = get_num_detected_faults_register_trans();
-//
-//	monitor_printf(mon, "Detected faults: \t\t | Number: \n");
-//	monitor_printf(mon, "RAM permanent \t\t\t | %d \n", total_num_detected_faults_ram_perm);
-//	monitor_printf(mon, "RAM transient \t\t\t | %d \n", total_num_detected_faults_ram_trans);
-//	monitor_printf(mon, "CPU permanent \t\t\t | %d \n", total_num_detected_faults_cpu_perm);
-//	monitor_printf(mon, "CPU transient \t\t\t | %d \n", total_num_detected_faults_cpu_trans);
-//	monitor_printf(mon, "Register permanent \t\t | %d \n", total_num_detected_faults_register_perm);
-//	monitor_printf(mon, "Register transient \t\t | %d \n", total_num_detected_faults_register_trans);
-//
-//	monitor_printf(mon, "--------------------------------------------------------------------------------\n");
-//
-//	if (total_num_injected_faults_ram_perm)
-//		dc_ram_perm = (total_num_detected_faults_ram_perm * 100.0f) / total_num_injected_faults_ram_perm;
-//
-//	if (total_num_injected_faults_ram_trans)
-//		dc_ram_trans = (total_num_detected_faults_ram_trans * 100.0f) / total_num_injected_faults_ram_trans;
-//
-//	if (total_num_injected_faults_cpu_perm)
-//		dc_cpu_perm = (total_num_detected_faults_cpu_perm * 100.0f) / total_num_injected_faults_cpu_perm;
-//	if (total_num_injected_faults_cpu_trans)
-//		dc_cpu_trans = (total_num_detected_faults_cpu_trans * 100.0f) / total_num_injected_faults_cpu_trans;
-//
-//	if (total_num_injected_faults_register_perm)
-//		dc_register_perm = (total_num_detected_faults_register_perm * 100.0f) / total_num_injected_faults_register_perm;
-//	if (total_num_injected_faults_register_trans)
-//		dc_register_trans = (total_num_detected_faults_register_trans * 100.0f) / total_num_injected_faults_register_trans;
-//
-//	monitor_printf(mon, "Diagnostic coverages: \t\t | Number: \n");
-//	monitor_printf(mon, "RAM permanent \t\t\t | %f \n", dc_ram_perm);
-//	monitor_printf(mon, "RAM transient \t\t\t | %f \n", dc_ram_trans);
-//	monitor_printf(mon, "CPU permanent \t\t\t | %f \n", dc_cpu_perm);
-//	monitor_printf(mon, "CPU transient \t\t\t | %f \n", dc_cpu_trans);
-//	monitor_printf(mon, "Register permanent \t\t | %f \n", dc_register_perm);
-//	monitor_printf(mon, "Register transient \t\t | %f \n", dc_register_trans);
-//
-//	monitor_printf(mon, "--------------------------------------------------------------------------------\n");
-
-	total_num_detected_faults = get_num_detected_faults();
-	total_num_injected_faults = get_num_injected_faults();
-
-	if (total_num_injected_faults)
-		dc_total = (total_num_detected_faults * 100.0f) / total_num_injected_faults;
-
-	monitor_printf(mon, "Total injected faults \t\t | %d \n", total_num_injected_faults);
-	monitor_printf(mon, "Total detected faults \t\t | %d \n", total_num_detected_faults);
-
-	monitor_printf(mon, "Total diagnostic coverage [%c] \t | %f \n", 37, dc_total);
-
+	fies_campaign_stats_print(mon);
 	monitor_printf(mon, "--------------------------------------------------------------------------------\n");
     qapi_free_FaultInfoList(fault_list);
 }
@@ -385,6 +304,8 @@ void hmp_info_migrate(Monitor *mon, const QDict *qdict)
                        info->xbzrle_cache->pages);
         monitor_printf(mon, "xbzrle cache miss: %" PRIu64 "\n",
                        info->xbzrle_cache->cache_miss);
+        monitor_printf(mon, "xbzrle cache hit: %" PRIu64 "\n",
+                       info->xbzrle_cache->cache_hit);
         monitor_printf(mon, "xbzrle overflow : %" PRIu64 "\n",
                        info->xbzrle_cache->overflow);
     }
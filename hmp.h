@@ -22,6 +22,7 @@ void hmp_info_name(Monitor *mon, const QDict *qdict);
 void hmp_info_version(Monitor *mon, const QDict *qdict);
 void hmp_info_faults(Monitor *mon, const QDict *qdict);
 void hmp_fault_reload(Monitor *mon, const QDict *qdict);
+void hmp_fault_rollback(Monitor *mon, const QDict *qdict);
 void hmp_info_kvm(Monitor *mon, const QDict *qdict);
 void hmp_info_status(Monitor *mon, const QDict *qdict);
 void hmp_info_uuid(Monitor *mon, const QDict *qdict);
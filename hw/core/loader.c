@@ -765,8 +765,18 @@ int rom_add_option(const char *file, int32_t bootindex)
 
 static void rom_reset(void *unused)
 {
+    static bool rom_reset_done;
     Rom *rom;
 
+    /* A golden RAM image was saved after the first reset, so the ROMs
+       are already in place.  Later resets must copy them again.  */
+    if (!rom_reset_done) {
+        rom_reset_done = true;
+        if (qemu_ram_all_golden()) {
+            return;
+        }
+    }
+
     QTAILQ_FOREACH(rom, &roms, next) {
         if (rom->fw_file) {
             continue;
@@ -0,0 +1,166 @@
+/*
+ * Table-driven MMIO register files
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ *
+ * A device describes its registers in a RegFileReg table instead of
+ * decoding offsets in a switch statement.  memory_region_init_regfile()
+ * turns the table into a per-word lookup array, so an access is one
+ * array index; registers that only hold a value are read and written
+ * directly in the device state, and only registers with side effects
+ * call back into the device.
+ */
+
+#include "hw/regfile.h"
+#include "qemu/log.h"
+
+static inline uint32_t *regfile_ptr(RegFile *rf, const RegFileReg *reg, int n)
+{
+    return (uint32_t *)((uint8_t *)rf->opaque + reg->field) + n;
+}
+
+static uint64_t regfile_read(void *opaque, hwaddr addr, unsigned size)
+{
+    RegFile *rf = opaque;
+    const RegFileSlot *slot;
+    const RegFileReg *reg;
+
+    if (!(addr & 3) && (addr >> 2) < rf->nb_slots) {
+        slot = &rf->slots[addr >> 2];
+        if (slot->reg >= 0) {
+            reg = &rf->info->regs[slot->reg];
+            if (reg->read) {
+                return reg->read(rf->opaque, slot->n);
+            }
+            if (reg->flags & REGFILE_UNIMP) {
+                qemu_log_mask(LOG_UNIMP, "%s: register %s not implemented\n",
+                              rf->info->name, reg->name);
+                return 0;
+            }
+            return *regfile_ptr(rf, reg, slot->n);
+        }
+    }
+    if (rf->info->read) {
+        return rf->info->read(rf->opaque, addr, size);
+    }
+    qemu_log_mask(LOG_GUEST_ERROR, "%s: bad register offset 0x%" HWADDR_PRIx
+                  "\n", rf->info->name, addr);
+    return 0;
+}
+
+static void regfile_write(void *opaque, hwaddr addr, uint64_t val,
+                          unsigned size)
+{
+    RegFile *rf = opaque;
+    const RegFileSlot *slot;
+    const RegFileReg *reg;
+    uint32_t *p, old;
+
+    if (!(addr & 3) && (addr >> 2) < rf->nb_slots) {
+        slot = &rf->slots[addr >> 2];
+        if (slot->reg >= 0) {
+            reg = &rf->info->regs[slot->reg];
+            if (reg->flags & REGFILE_RO) {
+                return;
+            }
+            if (reg->flags & REGFILE_UNIMP) {
+                qemu_log_mask(LOG_UNIMP, "%s: register %s not implemented\n",
+                              rf->info->name, reg->name);
+                return;
+            }
+            p = regfile_ptr(rf, reg, slot->n);
+            old = *p;
+            switch (slot->op) {
+            case REGFILE_OP_WRITE:
+                *p = val;
+                break;
+            case REGFILE_OP_SET:
+                *p = old | val;
+                break;
+            case REGFILE_OP_CLR:
+                *p = old & ~val;
+                break;
+            case REGFILE_OP_TOG:
+                *p = old ^ val;
+                break;
+            }
+            if (reg->write) {
+                reg->write(rf->opaque, slot->n, slot->op, old, val);
+            }
+            return;
+        }
+    }
+    if (rf->info->write) {
+        rf->info->write(rf->opaque, addr, val, size);
+        return;
+    }
+    qemu_log_mask(LOG_GUEST_ERROR, "%s: bad register offset 0x%" HWADDR_PRIx
+                  "\n", rf->info->name, addr);
+}
+
+static const MemoryRegionOps regfile_ops = {
+    .read = regfile_read,
+    .write = regfile_write,
+    .endianness = DEVICE_NATIVE_ENDIAN,
+};
+
+void memory_region_init_regfile(MemoryRegion *mr, Object *owner, RegFile *rf,
+                                const RegFileInfo *info, void *opaque)
+{
+    const RegFileReg *reg;
+    hwaddr addr, end = 0;
+    unsigned i, n, op, nb_ops;
+
+    for (i = 0; i < info->nb_regs; i++) {
+        reg = &info->regs[i];
+        assert(!(reg->addr & 3) && (reg->count <= 1 || reg->stride >= 4));
+        nb_ops = (reg->flags & REGFILE_SCT) ? 4 : 1;
+        addr = reg->addr + (MAX(reg->count, 1) - 1) * reg->stride +
+               nb_ops * 4;
+        end = MAX(end, addr);
+    }
+    assert(end <= info->size);
+
+    rf->info = info;
+    rf->opaque = opaque;
+    rf->nb_slots = end >> 2;
+    rf->slots = g_new(RegFileSlot, rf->nb_slots);
+    for (i = 0; i < rf->nb_slots; i++) {
+        rf->slots[i].reg = -1;
+    }
+    for (i = 0; i < info->nb_regs; i++) {
+        reg = &info->regs[i];
+        assert(reg->count <= 256);
+        nb_ops = (reg->flags & REGFILE_SCT) ? 4 : 1;
+        for (n = 0; n < MAX(reg->count, 1); n++) {
+            for (op = 0; op < nb_ops; op++) {
+                addr = (reg->addr + n * reg->stride + op * 4) >> 2;
+                assert(rf->slots[addr].reg < 0);
+                rf->slots[addr].reg = i;
+                rf->slots[addr].n = n;
+                rf->slots[addr].op = op;
+            }
+        }
+    }
+
+    memory_region_init_io(mr, owner, &regfile_ops, rf, info->name,
+                          info->size);
+}
+
+/* Set all registers to their reset values */
+void regfile_reset(RegFile *rf)
+{
+    const RegFileReg *reg;
+    unsigned i, n;
+
+    for (i = 0; i < rf->info->nb_regs; i++) {
+        reg = &rf->info->regs[i];
+        if (reg->flags & REGFILE_UNIMP) {
+            continue;
+        }
+        for (n = 0; n < MAX(reg->count, 1); n++) {
+            *regfile_ptr(rf, reg, n) = reg->reset;
+        }
+    }
+}
@@ -9,6 +9,7 @@
 //#include "qemu/timer.h"
 //#include "qemu/bitops.h"
 #include "hw/sysbus.h"
+#include "hw/regfile.h"
 #include "math.h"
 //#include "sysemu/sysemu.h"
 
@@ -26,6 +27,7 @@ typedef struct {
     SysBusDevice parent_obj;
 
     MemoryRegion iomem;
+    RegFile regfile;
 
     uint32_t moveable_pte[16];
     hwaddr mpte_base_addr[16];
@@ -57,10 +59,6 @@ static uint64_t imx28_dflpt_read(void *opaque, hwaddr offset,
 	uint64_t ret = 0;
 	int i = 0;
 
-	 /* fixed entry PIO register map */
-    if (offset == 0x2000)
-        return ((s->pio_register_map_entry) & 0xFFFFFFFB);
-
     /* MPTEi */
     for (i = 0; i < 16; i++)
     {
@@ -115,18 +113,6 @@ static void imx28_dflpt_write(void *opaque, hwaddr offset,
 	hwaddr hw_digctl_mpte_loc = 0;
 	int i = 0;
 
-	 /* fixed entry PIO register map */
-    if (offset == 0x2000)
-    {
-    	/* Set Acess Permission */
-    	s->pio_register_map_entry |= (val & 0xC00);
-    	/* Set Domain */
-    	s->pio_register_map_entry |= (val & 0x1E0);
-    	/* Set Bufferable */
-    	s->pio_register_map_entry |= (val & 0x4);
-        return;
-    }
-
     /* MPTEi */
     for (i = 0; i < 16; i++)
     {
@@ -182,10 +168,42 @@ static void imx28_dflpt_write(void *opaque, hwaddr offset,
     return;
 }
 
-static const MemoryRegionOps imx28_dflpt_ops = {
+/* fixed entry PIO register map */
+static uint32_t imx28_dflpt_pio_read(void *opaque, int n)
+{
+	imx28_dflpt_state *s = (imx28_dflpt_state *) opaque;
+
+	return s->pio_register_map_entry & 0xFFFFFFFB;
+}
+
+static void imx28_dflpt_pio_write(void *opaque, int n, RegFileOp op,
+                                  uint32_t old, uint32_t val)
+{
+	imx28_dflpt_state *s = (imx28_dflpt_state *) opaque;
+
+	s->pio_register_map_entry = old;
+	/* Set Acess Permission */
+	s->pio_register_map_entry |= (val & 0xC00);
+	/* Set Domain */
+	s->pio_register_map_entry |= (val & 0x1E0);
+	/* Set Bufferable */
+	s->pio_register_map_entry |= (val & 0x4);
+}
+
+static const RegFileReg imx28_dflpt_regs[] = {
+    { .name = "PIO register map entry", .addr = 0x2000,
+      .field = offsetof(imx28_dflpt_state, pio_register_map_entry),
+      .read = imx28_dflpt_pio_read, .write = imx28_dflpt_pio_write },
+};
+
+/* the movable PTEs are decoded by imx28_dflpt_read/imx28_dflpt_write */
+static const RegFileInfo imx28_dflpt_regfile = {
+    .name = "imx28_dflpt",
+    .size = 0x10000,
+    .regs = imx28_dflpt_regs,
+    .nb_regs = ARRAY_SIZE(imx28_dflpt_regs),
     .read = imx28_dflpt_read,
     .write = imx28_dflpt_write,
-    .endianness = DEVICE_NATIVE_ENDIAN,
 };
 
 static void imx28_dflpt_init(Object *obj)
@@ -197,8 +215,8 @@ static void imx28_dflpt_init(Object *obj)
 
     s->pio_register_map_entry = 0x80000C12;
 
-   memory_region_init_io(&s->iomem, OBJECT(dev), &imx28_dflpt_ops, s,
-                          "imx28_dflpt", 0x10000);
+    memory_region_init_regfile(&s->iomem, OBJECT(dev), &s->regfile,
+                               &imx28_dflpt_regfile, s);
     sysbus_init_mmio(sd, &s->iomem);
 }
 
@@ -6,6 +6,7 @@
  */
 
 #include "hw/sysbus.h"
+#include "hw/regfile.h"
 #include "qemu/timer.h"
 #include "qemu-common.h"
 #include "hw/qdev.h"
@@ -31,6 +32,7 @@ typedef struct IMX28TimerState {
     SysBusDevice parent_obj;
 
     MemoryRegion iomem;
+    RegFile regfile;
     ptimer_state *timer;
 
     uint32_t freq;
@@ -77,164 +79,174 @@ static void imx28_timer_tick(void *opaque)
     imx28_timer_update(s);
 }
 
-static uint64_t imx28_timer_read(void *opaque, hwaddr offset,
-                           unsigned size)
+/* Timer Running Count Register */
+static uint32_t imx28_timer_count_read(void *opaque, int n)
 {
-	//printf("\n++++++++++++++Timer Read %08x\n", (unsigned int)offset);
 	IMX28TimerState *s = (IMX28TimerState *) opaque;
 
-    uint32_t reg = offset >> 4;
+	return ptimer_get_count(s->timer);
+}
+
+/* Timer Control and Status Register */
+static void imx28_timer_control_write(void *opaque, int n, RegFileOp op,
+                                      uint32_t old, uint32_t value)
+{
+    IMX28TimerState *s = (IMX28TimerState *) opaque;
+    int freq = -1, reloaded = -1;
 
-    switch (reg)
+    if (old & TIMER_CTRL_SELECT_MASK)
     {
-    	case 0: /* Timer Control and Status Register */
-    		return s->control;
-    	case 1: /* Timer Runing Count Register */
-    		return ptimer_get_count(s->timer);
-    	case 2: /* Timer Fixed Count Register */
-    		return s->fixed_cnt;
-    	case 3: /* Timer Match Count Register */
-    		return s->match_cnt;
-    	default:
-            qemu_log_mask(LOG_GUEST_ERROR,
-                          "%s: Bad offset %x\n", __func__, (int)offset);
-            return 0;
+        /* Pause the timer if it is running.  This may cause some
+           inaccuracy dure to rounding, but avoids a whole lot of other
+           messyness.  */
+        ptimer_stop(s->timer);
     }
 
-    return 0;
+    switch (s->control & TIMER_CTRL_SELECT_MASK)
+    {
+        case 1: /* source of timer ticks is PWM0 */
+        case 2: /* source of timer ticks is PWM1 */
+        case 3: /* source of timer ticks is PWM2 */
+        case 4: /* source of timer ticks is PWM3 */
+        case 5: /* source of timer ticks is PWM4 */
+        case 6: /* source of timer ticks is PWM5 */
+        case 7: /* source of timer ticks is PWM6 */
+        case 8: /* source of timer ticks is PWM7 */
+        case 9: /* source of timer ticks is Rotary A */
+        case 10: /* source of timer ticks is Rotary B */
+            /* not supported */
+            freq = -1;
+            break;
+        case 11: /* source of timer ticks is 32kHz crystal*/
+            freq = 32000;
+            break;
+        case 12: /* source of timer ticks is 8kHz crystal*/
+            freq = 8000;
+            break;
+        case 13: /* source of timer ticks is 4kHz crystal*/
+            freq = 4000;
+            break;
+        case 14: /* source of timer ticks is 1kHz crystal*/
+            freq = 1000;
+            break;
+        case 15: /* always ticks*/
+            freq = s->freq;
+            break;
+        default:
+            freq = s->freq;
+            break;
+    }
+
+    switch ( (s->control >> TIMER_PRESACLER_SHIFT) & TIMER_PRESACLER_MASK )
+    {
+        case 1: freq >>= 1; break;
+        case 2: freq >>= 2; break;
+        case 3: freq >>= 3; break;
+    }
+
+    ptimer_set_freq(s->timer, freq);
+
+    reloaded = (s->control >> TIMER_CTRL_ONESHOT_SHIFT) & TIMER_CTRL_ONESHOT_MASK;
+
+    if ( (s->control >> TIMER_CTRL_UPDATE_SHIFT) & TIMER_CTRL_UPDATE_MASK )
+    {
+        ptimer_set_limit(s->timer, s->fixed_cnt , reloaded);
+        s->update = 0;
+    }
+    else
+    {
+        s->update = 1;
+    }
+
+    s->int_level = (s->control >> TIMER_CTRL_IRQ_SHIFT) & TIMER_CTRL_IRQ_MASK;
+
+    if (s->control & TIMER_CTRL_SELECT_MASK)
+    {
+        /* Restart the timer if still enabled.  */
+        ptimer_run(s->timer, !reloaded);
+    }
+
+    imx28_timer_update(s);
 }
 
-static void imx28_timer_write(void *opaque, hwaddr offset,
-                        uint64_t value, unsigned size)
+#define TIMER_REG(_name, _addr, _field, ...) \
+    { .name = (_name), .addr = (_addr), \
+      .field = offsetof(IMX28TimerState, _field), __VA_ARGS__ }
+
+static const RegFileReg imx28_timer_regs[] = {
+    TIMER_REG("Timer Control and Status Register", 0x00, control,
+              .flags = REGFILE_SCT, .write = imx28_timer_control_write),
+    { .name = "Timer Running Count Register", .addr = 0x10,
+      .flags = REGFILE_RO, .read = imx28_timer_count_read },
+    TIMER_REG("Timer Fixed Count Register", 0x20, fixed_cnt),
+    TIMER_REG("Timer Match Count Register", 0x30, match_cnt), /* not supported */
+};
+
+/* The hardware only decodes offset >> 4, so the other words of the count
+   registers' 16-byte blocks (and unaligned accesses) alias them */
+static uint64_t imx28_timer_alias_read(void *opaque, hwaddr offset,
+                                       unsigned size)
 {
-	//printf("\n+++++++++++++Timer Write %08x; %08x\n", (unsigned int) offset, (unsigned int) value);
-	IMX28TimerState *s = (IMX28TimerState *) opaque;
-    uint32_t reg = offset >> 4;
-    int freq = -1, reloaded = -1;
+    IMX28TimerState *s = (IMX28TimerState *) opaque;
 
-    switch (reg)
+    switch (offset >> 4)
     {
-    	case 0: /* Timer Control and Status Register */
-
-            if (s->control & TIMER_CTRL_SELECT_MASK)
-            {
-                /* Pause the timer if it is running.  This may cause some
-                   inaccuracy dure to rounding, but avoids a whole lot of other
-                   messyness.  */
-                ptimer_stop(s->timer);
-            }
-
-            if (offset == 0x0)
-            	s->control = value;
-            if (offset == 0x4)
-            	s->control |= value;
-            if (offset == 0x8)
-            	s->control &= ~value;
-            if (offset == 0xC)
-            	s->control ^= value;
-
-            switch (s->control & TIMER_CTRL_SELECT_MASK)
-            {
-            	case 1: /* source of timer ticks is PWM0 */
-            	case 2: /* source of timer ticks is PWM1 */
-            	case 3: /* source of timer ticks is PWM2 */
-            	case 4: /* source of timer ticks is PWM3 */
-            	case 5: /* source of timer ticks is PWM4 */
-            	case 6: /* source of timer ticks is PWM5 */
-            	case 7: /* source of timer ticks is PWM6 */
-            	case 8: /* source of timer ticks is PWM7 */
-            	case 9: /* source of timer ticks is Rotary A */
-            	case 10: /* source of timer ticks is Rotary B */
-            		/* not supported */
-            		freq = -1;
-            		break;
-            	case 11: /* source of timer ticks is 32kHz crystal*/
-            		freq = 32000;
-            		break;
-            	case 12: /* source of timer ticks is 8kHz crystal*/
-            		freq = 8000;
-            		break;
-            	case 13: /* source of timer ticks is 4kHz crystal*/
-            		freq = 4000;
-            		break;
-            	case 14: /* source of timer ticks is 1kHz crystal*/
-                    freq = 1000;
-            		break;
-                case 15: /* always ticks*/
-                    freq = s->freq;
-            		break;
-                default:
-                    freq = s->freq;
-                	break;
-            }
-
-            switch ( (value >> TIMER_PRESACLER_SHIFT) & TIMER_PRESACLER_MASK )
-            {
-            	case 1: freq >>= 1; break;
-            	case 2: freq >>= 2; break;
-            	case 3: freq >>= 3; break;
-            }
-
-            ptimer_set_freq(s->timer, freq);
-
-
-        	reloaded = (s->control >> TIMER_CTRL_ONESHOT_SHIFT) & TIMER_CTRL_ONESHOT_MASK;
-
-        	if ( (s->control >> TIMER_CTRL_UPDATE_SHIFT) & TIMER_CTRL_UPDATE_MASK )
-        	{
-                ptimer_set_limit(s->timer, s->fixed_cnt , reloaded);
-        		s->update = 0;
-        	}
-        	else
-        	{
-        		s->update = 1;
-        	}
-
-
-            s->int_level = (s->control >> TIMER_CTRL_IRQ_SHIFT) & TIMER_CTRL_IRQ_MASK;
-
-            if (s->control & TIMER_CTRL_SELECT_MASK)
-            {
-                /* Restart the timer if still enabled.  */
-                ptimer_run(s->timer, !reloaded);
-            }
-
-    		break;
-    	case 1: /* Timer Runing Count Register */
-    		/* Read only */
-    		return;
-    	case 2: /* Timer Fixed Count Register */
-    		s->fixed_cnt = value;
-    		break;
-    	case 3: /* Timer Match Count Register */
-    		s->match_cnt = value; /* not supported */
-    		break;
-    	default:
-            qemu_log_mask(LOG_GUEST_ERROR,
-                          "%s: Bad offset %x\n", __func__, (int)offset);
-            break;
+        case 0: /* Timer Control and Status Register */
+            return s->control;
+        case 1: /* Timer Running Count Register */
+            return ptimer_get_count(s->timer);
+        case 2: /* Timer Fixed Count Register */
+            return s->fixed_cnt;
+        case 3: /* Timer Match Count Register */
+            return s->match_cnt;
     }
-    imx28_timer_update(s);
+    qemu_log_mask(LOG_GUEST_ERROR, "%s: Bad offset %x\n", __func__,
+                  (int)offset);
+    return 0;
+}
+
+static void imx28_timer_alias_write(void *opaque, hwaddr offset,
+                                    uint64_t value, unsigned size)
+{
+    IMX28TimerState *s = (IMX28TimerState *) opaque;
 
+    switch (offset >> 4)
+    {
+        case 1: /* Timer Running Count Register */
+            /* Read only */
+            return;
+        case 2: /* Timer Fixed Count Register */
+            s->fixed_cnt = value;
+            return;
+        case 3: /* Timer Match Count Register */
+            s->match_cnt = value; /* not supported */
+            return;
+    }
+    qemu_log_mask(LOG_GUEST_ERROR, "%s: Bad offset %x\n", __func__,
+                  (int)offset);
 }
 
-static const MemoryRegionOps imx28_timer_ops = {
-    .read = imx28_timer_read,
-    .write = imx28_timer_write,
-    .endianness = DEVICE_NATIVE_ENDIAN,
+static const RegFileInfo imx28_timer_regfile = {
+    .name = TYPE_IMX28_TIMER,
+    .size = 0x40,
+    .regs = imx28_timer_regs,
+    .nb_regs = ARRAY_SIZE(imx28_timer_regs),
+    .read = imx28_timer_alias_read,
+    .write = imx28_timer_alias_write,
 };
 
 static const VMStateDescription vmstate_imx28_timer = {
     .name = "imx28_timer",
-    .version_id = 1,
-    .minimum_version_id = 1,
-    .minimum_version_id_old = 1,
+    .version_id = 2,
+    .minimum_version_id = 2,
+    .minimum_version_id_old = 2,
     .fields      = (VMStateField[]) {
     	VMSTATE_UINT32(control, IMX28TimerState),
     	VMSTATE_UINT32(fixed_cnt, IMX28TimerState),
     	VMSTATE_UINT32(match_cnt, IMX28TimerState),
     	VMSTATE_UINT32(int_level, IMX28TimerState),
     	VMSTATE_UINT32(update, IMX28TimerState),
+        VMSTATE_PTIMER(timer, IMX28TimerState),
         VMSTATE_END_OF_LIST()
     }
 };
@@ -247,8 +259,8 @@ static int imx28_init(SysBusDevice *sbd)
     QEMUBH *bh;
 
     sysbus_init_irq(sbd, &s->irq);
-    memory_region_init_io(&s->iomem, OBJECT(s), &imx28_timer_ops, s, TYPE_IMX28_TIMER,
-                          0x40);
+    memory_region_init_regfile(&s->iomem, OBJECT(s), &s->regfile,
+                               &imx28_timer_regfile, s);
     sysbus_init_mmio(sbd, &s->iomem);
 
     s->control = 0x0;
@@ -271,6 +283,7 @@ static void imx28_timer_class_init(ObjectClass *klass, void *data)
     DeviceClass *k = DEVICE_CLASS(klass);
 
     sdc->init = imx28_init;
+    k->vmsd = &vmstate_imx28_timer;
     k->props = imx28_properties;
 }
 
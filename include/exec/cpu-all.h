@@ -442,6 +442,13 @@ extern ram_addr_t ram_size;
 /* RAM is pre-allocated and passed into qemu_ram_alloc_from_ptr */
 #define RAM_PREALLOC_MASK   (1 << 0)
 
+/* RAM is a private mapping of a golden image (-mem-golden) */
+#define RAM_GOLDEN_MASK     (1 << 1)
+
+/* The RAM contents of a golden image follow a header of this size, which
+   is a multiple of the host page size */
+#define GOLDEN_RAM_HEADER_SIZE 0x10000
+
 typedef struct RAMBlock {
     struct MemoryRegion *mr;
     uint8_t *host;
@@ -454,6 +461,8 @@ typedef struct RAMBlock {
      */
     QTAILQ_ENTRY(RAMBlock) next;
     int fd;
+    /* What the golden image of the block has to be made from (-mem-golden) */
+    uint32_t golden_id;
 } RAMBlock;
 
 typedef struct RAMList {
@@ -469,6 +478,7 @@ extern RAMList ram_list;
 
 extern const char *mem_path;
 extern int mem_prealloc;
+extern const char *mem_golden;
 
 /* Flags stored in the low bits of the TLB virtual address.  These are
    defined so that fast path ram access is all zeros.  */
@@ -479,6 +489,9 @@ extern int mem_prealloc;
 #define TLB_NOTDIRTY    (1 << 4)
 /* Set if TLB entry is an IO callback.  */
 #define TLB_MMIO        (1 << 5)
+/* Set if the page holds the address of a FIES memory fault.  Accesses take
+   the slow path, which calls the fault injection controller.  */
+#define TLB_FAULT       (1 << 6)
 
 void dump_exec_info(FILE *f, fprintf_function cpu_fprintf);
 ram_addr_t last_ram_offset(void);
@@ -94,6 +94,7 @@ void tb_invalidate_phys_page_range(tb_page_addr_t start, tb_page_addr_t end,
                                    int is_cpu_write_access);
 void tb_invalidate_phys_range(tb_page_addr_t start, tb_page_addr_t end,
                               int is_cpu_write_access);
+bool tb_is_store_free_loop(uintptr_t tc_ptr, int max_tbs);
 #if !defined(CONFIG_USER_ONLY)
 /* cputlb.c */
 void tlb_flush_page(CPUArchState *env, target_ulong addr);
@@ -102,6 +103,8 @@ void tlb_set_page(CPUArchState *env, target_ulong vaddr,
                   hwaddr paddr, int prot,
                   int mmu_idx, target_ulong size);
 void tb_invalidate_phys_addr(hwaddr addr);
+/* translate-all.c */
+bool tb_prefetch(CPUArchState *env);
 #else
 static inline void tlb_flush_page(CPUArchState *env, target_ulong addr)
 {
@@ -139,9 +142,13 @@ struct TranslationBlock {
     uint64_t flags; /* flags defining in which context the code was generated */
     uint16_t size;      /* size of target code for this block (1 <=
                            size <= TARGET_PAGE_SIZE) */
-    uint16_t cflags;    /* compile flags */
+    uint32_t cflags;    /* compile flags */
 #define CF_COUNT_MASK  0x7fff
 #define CF_LAST_IO     0x8000 /* Last insn may be an IO access.  */
+#define CF_SUPERBLOCK  0x10000 /* Continue across conditional branches.  */
+#define CF_SB_TAKEN    0x20000 /* The first branch is usually taken.  */
+#define CF_INVALID     0x40000 /* Removed by tb_phys_invalidate().  */
+#define CF_PREFETCHED  0x80000 /* Translated by -tb-prefetch, not run yet.  */
 
     uint8_t *tc_ptr;    /* pointer to the translated code */
     /* next matching tb for physical address. */
@@ -166,12 +173,23 @@ struct TranslationBlock {
     struct TranslationBlock *jmp_next[2];
     struct TranslationBlock *jmp_first;
     uint32_t icount;
+    uint8_t has_stores; /* the block contains guest memory stores */
+    /* -superblocks profile: executions, and exits through jump 0 */
+    uint32_t exec_count;
+    uint32_t taken_count;
+    /* guest PCs of the direct jump targets, or -1 (for -tb-prefetch) */
+    target_ulong succ_pc[2];
+    /* guest registers read or written by the block (bit n = register n),
+       see tb_invalidate_regs() */
+    uint32_t regs_accessed;
 };
 
 #include "exec/spinlock.h"
 
 typedef struct TBContext TBContext;
 
+#define TB_MAX_REGIONS 8
+
 struct TBContext {
 
     TranslationBlock *tbs;
@@ -180,9 +198,26 @@ struct TBContext {
     /* any access to the tbs or the page table must use this lock */
     spinlock_t tb_lock;
 
+    /* The code buffer and tbs are split into nb_regions regions that are
+       filled in turn.  When the last one is full, only the TBs of the
+       oldest region are invalidated (see tb_alloc).  Region r holds
+       region_nb_tbs[r] TBs from tbs[r * region_max_blocks] on, and
+       region_code[r] bytes of code (except for the current region,
+       which ends at code_gen_ptr).  */
+    int nb_regions;
+    int region;
+    size_t region_size;
+    int region_max_blocks;
+    int region_nb_tbs[TB_MAX_REGIONS];
+    size_t region_code[TB_MAX_REGIONS];
+
     /* statistics */
     int tb_flush_count;
     int tb_phys_invalidate_count;
+    int region_evict_count;
+    int region_evict_tbs;
+    int tb_prefetch_count;
+    int tb_prefetch_hit_count;
 
     int tb_invalidated_flag;
 };
@@ -210,6 +245,8 @@ static inline unsigned int tb_phys_hash_func(tb_page_addr_t pc)
 void tb_free(TranslationBlock *tb);
 void tb_flush(CPUArchState *env);
 void tb_phys_invalidate(TranslationBlock *tb, tb_page_addr_t page_addr);
+void tb_invalidate_regs(uint32_t regs);
+void *tb_lookup_tc_ptr(CPUArchState *env);
 
 #if defined(USE_DIRECT_JUMP)
 
@@ -374,9 +411,15 @@ void cpu_set_debug_excp_handler(CPUDebugExcpHandler *handler);
 
 /* vl.c */
 extern int singlestep;
+extern int busy_wait_warp;
+extern int superblock_threshold;
+extern int tb_prefetch_size;
 
 /* cpu-exec.c */
 extern volatile sig_atomic_t exit_request;
+void cpu_busy_wait_mmio_read(CPUArchState *env, hwaddr physaddr,
+                             uintptr_t retaddr);
+void cpu_busy_wait_mmio_write(void);
 
 /* Deterministic execution requires that IO only be performed on the last
    instruction of a TB so that interrupts take effect immediately.  */
@@ -42,6 +42,7 @@ void qemu_ram_free_from_ptr(ram_addr_t addr);
 
 #define VGA_DIRTY_FLAG       0x01
 #define CODE_DIRTY_FLAG      0x02
+#define JOURNAL_DIRTY_FLAG   0x04 /* page saved in the FIES rollback journal */
 #define MIGRATION_DIRTY_FLAG 0x08
 
 static inline int cpu_physical_memory_get_dirty_flags(ram_addr_t addr)
@@ -134,6 +134,11 @@ static inline DATA_TYPE glue(io_read, SUFFIX)(CPUArchState *env,
 
     env->mem_io_vaddr = addr;
     io_mem_read(mr, physaddr, &val, 1 << SHIFT);
+#ifndef SOFTMMU_CODE_ACCESS
+    if (busy_wait_warp) {
+        cpu_busy_wait_mmio_read(env, physaddr, retaddr);
+    }
+#endif
     fault_injection_controller_init(env, (&addr64), ((uint32_t*)&val), FI_MEMORY_CONTENT, read_access_type);
 
 
@@ -172,7 +177,7 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
     }
 
     /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_FAULT))) {
         hwaddr ioaddr;
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
@@ -261,7 +266,7 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
     }
 
     /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_FAULT))) {
         hwaddr ioaddr;
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
@@ -372,6 +377,9 @@ static inline void glue(io_write, SUFFIX)(CPUArchState *env,
     env->mem_io_pc = retaddr;
     fault_injection_controller_init(env, (&addr64), ((uint32_t*)&val), FI_MEMORY_CONTENT, write_access_type);
     io_mem_write(mr, physaddr, val, 1 << SHIFT);
+    if (busy_wait_warp) {
+        cpu_busy_wait_mmio_write();
+    }
 }
 
 void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
@@ -401,7 +409,7 @@ void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
     }
 
     /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_FAULT))) {
         hwaddr ioaddr;
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
@@ -485,7 +493,7 @@ void helper_be_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
     }
 
     /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_FAULT))) {
         hwaddr ioaddr;
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
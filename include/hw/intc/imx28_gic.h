@@ -10,6 +10,7 @@
 
 #include "hw/sysbus.h"
 #include "hw/intc/arm_gic.h"
+#include "hw/regfile.h"
 
 #define TYPE_IMX28_GIC "imx28_gic"
 #define IMX28_GIC(obj) \
@@ -174,6 +175,7 @@ typedef struct IMX28GICState {
     SysBusDevice parent_obj;
 
     MemoryRegion iomem;
+    RegFile regfile;
 
     qemu_irq irq;
     qemu_irq fiq;
@@ -0,0 +1,75 @@
+/*
+ * Table-driven MMIO register files
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#ifndef HW_REGFILE_H
+#define HW_REGFILE_H
+
+#include "exec/memory.h"
+#include "qom/object.h"
+
+/* Writes are ignored */
+#define REGFILE_RO      (1 << 0)
+/* Set, clear and toggle aliases at +0x4, +0x8 and +0xc (i.MX style) */
+#define REGFILE_SCT     (1 << 1)
+/* Known but not emulated: reads as zero, writes are ignored, both logged */
+#define REGFILE_UNIMP   (1 << 2)
+
+typedef enum RegFileOp {
+    REGFILE_OP_WRITE,
+    REGFILE_OP_SET,
+    REGFILE_OP_CLR,
+    REGFILE_OP_TOG,
+} RegFileOp;
+
+/*
+ * One register, or 'count' registers 'stride' bytes apart.  The value of
+ * register n is the uint32_t at 'field' + n * 4 in the device state, so
+ * plain registers are read and written without calling into the device.
+ */
+typedef struct RegFileReg {
+    const char *name;
+    hwaddr addr;
+    unsigned count;
+    hwaddr stride;
+    size_t field;
+    unsigned flags;
+    uint32_t reset;
+    /* Optional: replaces reading the stored value */
+    uint32_t (*read)(void *opaque, int n);
+    /* Optional: called after the stored value has been updated */
+    void (*write)(void *opaque, int n, RegFileOp op, uint32_t old,
+                  uint32_t val);
+} RegFileReg;
+
+typedef struct RegFileInfo {
+    const char *name;
+    uint64_t size;
+    const RegFileReg *regs;
+    int nb_regs;
+    /* Optional: handle offsets that are not in 'regs' */
+    uint64_t (*read)(void *opaque, hwaddr addr, unsigned size);
+    void (*write)(void *opaque, hwaddr addr, uint64_t val, unsigned size);
+} RegFileInfo;
+
+typedef struct RegFileSlot {
+    int16_t reg;
+    uint8_t n;
+    uint8_t op;
+} RegFileSlot;
+
+typedef struct RegFile {
+    const RegFileInfo *info;
+    void *opaque;
+    RegFileSlot *slots;
+    unsigned nb_slots;
+} RegFile;
+
+void memory_region_init_regfile(MemoryRegion *mr, Object *owner, RegFile *rf,
+                                const RegFileInfo *info, void *opaque);
+void regfile_reset(RegFile *rf);
+
+#endif
@@ -113,6 +113,7 @@ uint64_t xbzrle_mig_bytes_transferred(void);
 uint64_t xbzrle_mig_pages_transferred(void);
 uint64_t xbzrle_mig_pages_overflow(void);
 uint64_t xbzrle_mig_pages_cache_miss(void);
+uint64_t xbzrle_mig_pages_cache_hit(void);
 
 void ram_handle_compressed(void *host, uint8_t ch, uint64_t size);
 
@@ -139,6 +140,21 @@ int xbzrle_encode_buffer(uint8_t *old_buf, uint8_t *new_buf, int slen,
                          uint8_t *dst, int dlen);
 int xbzrle_decode_buffer(uint8_t *src, int slen, uint8_t *dst, int dlen);
 
+typedef enum XbzrleAccel {
+    XBZRLE_ACCEL_LONG,
+    XBZRLE_ACCEL_SSE2,
+    XBZRLE_ACCEL_AVX2,
+    XBZRLE_ACCEL_MAX,
+} XbzrleAccel;
+
+typedef int XbzrleEncodeFunc(uint8_t *old_buf, uint8_t *new_buf, int slen,
+                             uint8_t *dst, int dlen);
+
+/* All encoders produce the same output.  Returns NULL if @accel is not
+ * supported by this build or host.
+ */
+XbzrleEncodeFunc *xbzrle_encoder(XbzrleAccel accel);
+
 int migrate_use_xbzrle(void);
 int64_t migrate_xbzrle_cache_size(void);
 
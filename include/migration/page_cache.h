@@ -37,19 +37,22 @@ PageCache *cache_init(int64_t num_pages, unsigned int page_size);
 void cache_fini(PageCache *cache);
 
 /**
- * cache_is_cached: Checks to see if the page is cached
+ * cache_is_cached: Checks to see if the page is cached, and marks it as
+ * the most recently used page if it is
  *
  * Returns %true if page is cached
  *
  * @cache pointer to the PageCache struct
  * @addr: page addr
  */
-bool cache_is_cached(const PageCache *cache, uint64_t addr);
+bool cache_is_cached(PageCache *cache, uint64_t addr);
 
 /**
  * get_cached_data: Get the data cached for an addr
  *
- * Returns pointer to the data cached or NULL if not cached
+ * Returns pointer to the data cached or NULL if not cached.  The buffer
+ * is only valid until the next cache_insert() or cache_resize(), which
+ * may reuse or free it.
  *
  * @cache pointer to the PageCache struct
  * @addr: page addr
@@ -58,7 +61,9 @@ uint8_t *get_cached_data(const PageCache *cache, uint64_t addr);
 
 /**
  * cache_insert: insert the page into the cache. the page cache
- * will dup the data on insert. the previous value will be overwritten
+ * will dup the data on insert. the previous value will be overwritten,
+ * or if the page was not cached, the least recently used page of its set
+ * is evicted when the set is full
  *
  * @cache pointer to the PageCache struct
  * @addr: page address
@@ -67,8 +72,8 @@ uint8_t *get_cached_data(const PageCache *cache, uint64_t addr);
 void cache_insert(PageCache *cache, uint64_t addr, uint8_t *pdata);
 
 /**
- * cache_resize: resize the page cache. In case of size reduction the extra
- * pages will be freed
+ * cache_resize: resize the page cache. The cached pages are kept; in case
+ * of size reduction the least recently used extra pages will be freed
  *
  * Returns -1 on error new cache size on success
  *
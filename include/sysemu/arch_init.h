@@ -25,6 +25,7 @@ enum {
 };
 
 extern const uint32_t arch_type;
+extern int savevm_threads;
 
 void select_soundhw(const char *optarg);
 void do_acpitable_option(const QemuOpts *opts);
@@ -12,6 +12,7 @@ void cpu_synchronize_all_post_reset(void);
 void cpu_synchronize_all_post_init(void);
 
 void qtest_clock_warp(int64_t dest);
+int64_t qemu_clock_warp_to_deadline(int64_t limit);
 
 #ifndef CONFIG_USER_ONLY
 /* vl.c */
@@ -86,6 +86,8 @@ void qemu_savevm_state_complete(QEMUFile *f);
 void qemu_savevm_state_cancel(void);
 uint64_t qemu_savevm_state_pending(QEMUFile *f, uint64_t max_size);
 int qemu_loadvm_state(QEMUFile *f);
+GByteArray *qemu_save_device_state_mem(void);
+int qemu_load_device_state_mem(GByteArray *state);
 
 /* SLIRP */
 void do_info_slirp(Monitor *mon);
@@ -124,6 +126,7 @@ extern int graphic_rotate;
 extern int no_quit;
 extern int no_shutdown;
 extern int semihosting_enabled;
+extern const char *semihosting_console;
 extern int old_param;
 extern int boot_menu;
 extern uint8_t *boot_splash_filedata;
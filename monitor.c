@@ -71,6 +71,7 @@
 #include "fault-injection-collector.h"
 #include "fault-injection-controller.h"
 #include "fault-injection-config.h"
+#include "fault-injection-profile.h"
 
 /* for pic/irq_info */
 #if defined(TARGET_SPARC)
@@ -2038,6 +2039,11 @@ static void do_info_profile(Monitor *mon, const QDict *qdict)
 }
 #endif
 
+static void do_info_fies_profile(Monitor *mon, const QDict *qdict)
+{
+    fies_profile_dump((FILE *)mon, monitor_fprintf);
+}
+
 /* Capture support */
 static QLIST_HEAD (capture_list_head, CaptureState) capture_head;
 
@@ -2642,6 +2648,13 @@ static mon_cmd_t info_cmds[] = {
     	.help       = "show all injected fault",
     	.mhandler.cmd = hmp_info_faults,
 	},
+	{
+		.name       = "fies-profile",
+		.args_type  = "",
+		.params     = "",
+		.help       = "show FIES hook profiling information",
+		.mhandler.cmd = do_info_fies_profile,
+	},
     {
         .name       = "version",
         .args_type  = "",
@@ -23,6 +23,7 @@
 #include <glib.h>
 
 #include "qemu-common.h"
+#include "qemu/host-utils.h"
 #include "migration/page_cache.h"
 
 #ifdef DEBUG_CACHE
@@ -41,10 +42,20 @@ struct CacheItem {
     uint8_t *it_data;
 };
 
+/*
+ * The cache is set associative: a page can be kept in any of the
+ * num_ways items of the set that its address hashes to.  Every lookup
+ * that hits refreshes the age of the item, and an insert into a full set
+ * replaces the least recently used item.
+ */
+#define CACHE_WAYS 4
+
 struct PageCache {
     CacheItem *page_cache;
     unsigned int page_size;
     int64_t max_num_items;
+    unsigned int num_ways;
+    unsigned int set_bits;
     uint64_t max_item_age;
     int64_t num_items;
 };
@@ -71,8 +82,11 @@ PageCache *cache_init(int64_t num_pages, unsigned int page_size)
     cache->num_items = 0;
     cache->max_item_age = 0;
     cache->max_num_items = num_pages;
+    cache->num_ways = MIN(CACHE_WAYS, num_pages);
+    cache->set_bits = ctz64(num_pages / cache->num_ways);
 
-    DPRINTF("Setting cache buckets to %" PRId64 "\n", cache->max_num_items);
+    DPRINTF("Setting cache buckets to %" PRId64 " in sets of %u\n",
+            cache->max_num_items, cache->num_ways);
 
     cache->page_cache = g_malloc((cache->max_num_items) *
                                  sizeof(*cache->page_cache));
@@ -101,43 +115,79 @@ void cache_fini(PageCache *cache)
     cache->page_cache = NULL;
 }
 
-static size_t cache_get_cache_pos(const PageCache *cache,
-                                  uint64_t address)
+static CacheItem *cache_get_set(const PageCache *cache, uint64_t address)
 {
-    size_t pos;
+    uint64_t page = address / cache->page_size;
+    size_t pos = 0;
 
     g_assert(cache->max_num_items);
-    pos = (address / cache->page_size) & (cache->max_num_items - 1);
-    return pos;
+    /* Multiplicative hash, so that pages with a power of 2 stride do not
+       all end up in the same few sets */
+    if (cache->set_bits) {
+        pos = (page * 0x9e3779b97f4a7c15ULL) >> (64 - cache->set_bits);
+    }
+    return &cache->page_cache[pos * cache->num_ways];
 }
 
-bool cache_is_cached(const PageCache *cache, uint64_t addr)
+static CacheItem *cache_get_by_addr(const PageCache *cache, uint64_t addr)
 {
-    size_t pos;
+    CacheItem *set;
+    unsigned int i;
 
     g_assert(cache);
     g_assert(cache->page_cache);
 
-    pos = cache_get_cache_pos(cache, addr);
-
-    return (cache->page_cache[pos].it_addr == addr);
+    set = cache_get_set(cache, addr);
+    for (i = 0; i < cache->num_ways; i++) {
+        if (set[i].it_data && set[i].it_addr == addr) {
+            return &set[i];
+        }
+    }
+    return NULL;
 }
 
-static CacheItem *cache_get_by_addr(const PageCache *cache, uint64_t addr)
+/* The item addr is cached in, else a free or the least recently used
+   item of its set */
+static CacheItem *cache_get_victim(const PageCache *cache, uint64_t addr)
 {
-    size_t pos;
+    CacheItem *set, *victim;
+    unsigned int i;
 
-    g_assert(cache);
-    g_assert(cache->page_cache);
+    victim = cache_get_by_addr(cache, addr);
+    if (victim) {
+        return victim;
+    }
+
+    set = cache_get_set(cache, addr);
+    victim = &set[0];
+    for (i = 0; i < cache->num_ways; i++) {
+        if (!set[i].it_data) {
+            return &set[i];
+        }
+        if (set[i].it_age < victim->it_age) {
+            victim = &set[i];
+        }
+    }
+    return victim;
+}
 
-    pos = cache_get_cache_pos(cache, addr);
+bool cache_is_cached(PageCache *cache, uint64_t addr)
+{
+    CacheItem *it;
 
-    return &cache->page_cache[pos];
+    it = cache_get_by_addr(cache, addr);
+    if (!it) {
+        return false;
+    }
+    it->it_age = ++cache->max_item_age;
+    return true;
 }
 
 uint8_t *get_cached_data(const PageCache *cache, uint64_t addr)
 {
-    return cache_get_by_addr(cache, addr)->it_data;
+    CacheItem *it = cache_get_by_addr(cache, addr);
+
+    return it ? it->it_data : NULL;
 }
 
 void cache_insert(PageCache *cache, uint64_t addr, uint8_t *pdata)
@@ -149,24 +199,33 @@ void cache_insert(PageCache *cache, uint64_t addr, uint8_t *pdata)
     g_assert(cache->page_cache);
 
     /* actual update of entry */
-    it = cache_get_by_addr(cache, addr);
-
-    /* free old cached data if any */
-    g_free(it->it_data);
+    it = cache_get_victim(cache, addr);
 
     if (!it->it_data) {
+        it->it_data = g_malloc(cache->page_size);
         cache->num_items++;
+    } else if (it->it_addr != addr) {
+        DPRINTF("Evicting %" PRIx64 " for %" PRIx64 "\n", it->it_addr, addr);
     }
 
-    it->it_data = g_memdup(pdata, cache->page_size);
+    memcpy(it->it_data, pdata, cache->page_size);
     it->it_age = ++cache->max_item_age;
     it->it_addr = addr;
 }
 
+static int cache_item_cmp_age(const void *a, const void *b)
+{
+    const CacheItem *it_a = *(CacheItem * const *)a;
+    const CacheItem *it_b = *(CacheItem * const *)b;
+
+    return it_a->it_age < it_b->it_age ? -1 : it_a->it_age > it_b->it_age;
+}
+
 int64_t cache_resize(PageCache *cache, int64_t new_num_pages)
 {
     PageCache *new_cache;
-    int64_t i;
+    CacheItem **items;
+    int64_t i, nb_items = 0;
 
     CacheItem *old_it, *new_it;
 
@@ -188,30 +247,35 @@ int64_t cache_resize(PageCache *cache, int64_t new_num_pages)
         return -1;
     }
 
-    /* move all data from old cache */
+    /* move all data from old cache, from the least to the most recently
+       used page, so that the most recently used pages are kept when the
+       cache shrinks */
+    items = g_new(CacheItem *, cache->num_items);
     for (i = 0; i < cache->max_num_items; i++) {
-        old_it = &cache->page_cache[i];
-        if (old_it->it_addr != -1) {
-            /* check for collision, if there is, keep MRU page */
-            new_it = cache_get_by_addr(new_cache, old_it->it_addr);
-            if (new_it->it_data && new_it->it_age >= old_it->it_age) {
-                /* keep the MRU page */
-                g_free(old_it->it_data);
-            } else {
-                if (!new_it->it_data) {
-                    new_cache->num_items++;
-                }
-                g_free(new_it->it_data);
-                new_it->it_data = old_it->it_data;
-                new_it->it_age = old_it->it_age;
-                new_it->it_addr = old_it->it_addr;
-            }
+        if (cache->page_cache[i].it_data) {
+            items[nb_items++] = &cache->page_cache[i];
+        }
+    }
+    qsort(items, nb_items, sizeof(*items), cache_item_cmp_age);
+
+    for (i = 0; i < nb_items; i++) {
+        old_it = items[i];
+        new_it = cache_get_victim(new_cache, old_it->it_addr);
+        if (!new_it->it_data) {
+            new_cache->num_items++;
         }
+        g_free(new_it->it_data);
+        new_it->it_data = old_it->it_data;
+        new_it->it_age = old_it->it_age;
+        new_it->it_addr = old_it->it_addr;
     }
+    g_free(items);
 
     g_free(cache->page_cache);
     cache->page_cache = new_cache->page_cache;
     cache->max_num_items = new_cache->max_num_items;
+    cache->num_ways = new_cache->num_ways;
+    cache->set_bits = new_cache->set_bits;
     cache->num_items = new_cache->num_items;
 
     g_free(new_cache);
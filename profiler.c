@@ -13,6 +13,8 @@ int open_register_file = 0;
 FILE *outfile_memory;
 FILE *outfile_registers;
 
+uint64_t profile_insn_count = 0;
+
 void profiler_log(CPUArchState *env, hwaddr *addr, uint32_t *value, AccessType access_type)
 {
 	if (access_type == write_access_type || access_type == read_access_type)
@@ -87,3 +89,13 @@ void profiler_close_files(void)
 		open_register_file = 0;
 	}
 }
+
+/**
+ * Prints the number of executed guest instructions to stderr. Registered
+ * with atexit() by the -profiling i option.
+ */
+void profiler_report_instructions(void)
+{
+	fprintf(stderr, "FIES: %" PRIu64 " guest instructions executed\n",
+			profile_insn_count);
+}
@@ -8,8 +8,11 @@
 #ifndef PROFILER_H_
 #define PROFILER_H_
 
+#include "qemu-common.h"
+#ifdef NEED_CPU_H
 #include "cpu.h"
 #include "fault-injection-controller.h"
+#endif
 
 #define OUTPUT_FILE_NAME_ACCESSED_MEMORY_ADDRESSES "profiling_memory.txt"
 #define OUTPUT_FILE_NAME_ACCESSED_REGS "profiling_registers.txt"
@@ -19,12 +22,19 @@ extern unsigned int profile_ram_addresses;
 extern unsigned int profile_pc_status;
 extern unsigned int profile_registers;
 extern unsigned int profile_condition_flags;
+extern unsigned int profile_instructions;
 
+/* Number of guest instructions executed, counted by the time hook */
+extern uint64_t profile_insn_count;
 
+
+#ifdef NEED_CPU_H
 void profiler_log_memory_access(CPUArchState *env, hwaddr *addr, uint32_t *value, AccessType access_type);
 void profiler_close_files(void);
 void set_profile_ram_addresses(int flag);
 void profiler_log(CPUArchState *env, hwaddr *addr, uint32_t *value, AccessType access_type);
 void profiler_log_register_access(CPUArchState *env, hwaddr *addr, uint32_t *value, AccessType access_type);
+#endif
+void profiler_report_instructions(void);
 
 #endif /* PROFILER_H_ */
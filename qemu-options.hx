@@ -27,12 +27,52 @@ STEXI
 Activates the fault injection experiment
 ETEXI
 
+DEF("fi-campaign", HAS_ARG, QEMU_OPTION_fi_campaign,
+    "-fi-campaign file=FILE[,insn-limit=N][,experiment=N]\n"
+    "                append the outcome of this experiment to a campaign file\n",
+    QEMU_ARCH_ALL)
+STEXI
+@item -fi-campaign file=@var{file}[,insn-limit=@var{n}][,experiment=@var{n}]
+@findex -fi-campaign
+At exit, append one outcome record per fault of the fault library to the
+campaign file @var{file}, and an index entry to @file{@var{file}.idx}.
+Experiments running in parallel may share the same campaign file.
+
+The outcome of an experiment is @code{masked} if the guest exits through
+semihosting with the regular application exit reason, @code{detected} if it
+exits with any other reason (e.g. @code{abort()}), @code{crash} if it is
+stopped after taking an undefined instruction or abort exception once a
+fault was activated, and @code{hang} otherwise. @option{insn-limit} stops
+the experiment after @var{n} guest instructions. @option{experiment} sets
+the experiment number, which otherwise is the number of experiments already
+recorded. @code{info faults} shows the outcome and diagnostic coverage of
+all recorded experiments per component, target and mode.
+ETEXI
+
+DEF("fi-journal", 0, QEMU_OPTION_fi_journal,
+    "-fi-journal     keep an undo journal of guest RAM and the device state\n"
+    "                for the fault_rollback monitor command\n",
+    QEMU_ARCH_ALL)
+STEXI
+@item -fi-journal
+@findex -fi-journal
+Save the device and CPU state once the machine has been reset (or the
+@option{-loadvm} snapshot has been loaded), and from then on save every page
+of guest RAM before it is written for the first time.  The monitor command
+@code{fault_rollback} (QMP @code{fault-rollback}) writes these pages back and
+restores the saved state, so the next experiment can be run in the same
+process.
+ETEXI
+
 DEF("profiling", HAS_ARG, QEMU_OPTION_profiling,
     "-profiling  activates profiling of memory/register usage of the binary\n", QEMU_ARCH_ALL)
 STEXI
 @item -profiling @var{item1}[,...]
 @findex -profiling
-Activates profiling of memory/register usage of the binary
+Activates profiling of memory/register usage of the binary. Items are
+@code{m} (memory accesses), @code{r} (register accesses), @code{c}
+(condition flags), @code{p} (PC status) and @code{i} (print the number of
+executed guest instructions at exit).
 ETEXI
 
 
@@ -245,6 +285,24 @@ STEXI
 Allocate guest RAM from a temporarily created file in @var{path}.
 ETEXI
 
+DEF("mem-golden", HAS_ARG, QEMU_OPTION_mem_golden,
+    "-mem-golden DIR map guest RAM copy-on-write from golden images in DIR\n",
+    QEMU_ARCH_ALL)
+STEXI
+@item -mem-golden @var{dir}
+@findex -mem-golden
+Back each guest RAM region with a private, copy-on-write mapping of the
+file @var{dir}/@var{region name} (e.g. @file{imx28.ram}).  Processes started
+from the same images share all guest pages they do not modify, and the
+kernel and ROM images are not copied into guest memory at startup.  Missing
+images are created from the guest memory after the first system reset.
+Every image records the machine type, the region, its size, the kernel,
+initrd and device tree contents and the kernel command line it was made
+for; an image that does not match is written again, with a message.
+Placing @var{dir} on a tmpfs such as @file{/dev/shm} keeps the shared pages
+in the page cache.
+ETEXI
+
 #ifdef MAP_POPULATE
 DEF("mem-prealloc", 0, QEMU_OPTION_mem_prealloc,
     "-mem-prealloc   preallocate guest memory (use with -mem-path)\n",
@@ -2745,6 +2803,22 @@ STEXI
 Start right away with a saved state (@code{loadvm} in monitor)
 ETEXI
 
+DEF("savevm-threads", HAS_ARG, QEMU_OPTION_savevm_threads, \
+    "-savevm-threads n\n" \
+    "                compress snapshots of guest RAM with n threads\n",
+    QEMU_ARCH_ALL)
+STEXI
+@item -savevm-threads @var{n}
+@findex -savevm-threads
+Write guest RAM in @code{savevm} snapshots as zlib compressed chunks of
+256 KiB that are compressed by @var{n} threads, and decompress them with
+@var{n} threads on @code{loadvm}.  Zero pages are not stored, and with
+@option{-mem-golden} neither are pages that still hold the contents of the
+golden image; such snapshots can only be loaded with the same golden images,
+and @code{loadvm} fails with any other image.
+Snapshots written without this option can always be loaded.
+ETEXI
+
 #ifndef _WIN32
 DEF("daemonize", 0, QEMU_OPTION_daemonize, \
     "-daemonize      daemonize QEMU after initializing\n", QEMU_ARCH_ALL)
@@ -2828,6 +2902,61 @@ order cores with complex cache hierarchies.  The number of instructions
 executed often has little or no correlation with actual performance.
 ETEXI
 
+DEF("warp-busy-wait", 0, QEMU_OPTION_warp_busy_wait, \
+    "-warp-busy-wait\n" \
+    "                fast-forward the virtual clock while the guest polls\n" \
+    "                device registers in a tight loop\n", QEMU_ARCH_ALL)
+STEXI
+@item -warp-busy-wait
+@findex -warp-busy-wait
+Detect loops that do nothing but read the same device registers, such as a
+firmware polling a timer, and advance the virtual clock straight to the next
+timer deadline instead of executing the loop until it is reached.  A loop is
+recognized after it has read its registers a few hundred times without
+writing to memory or to a device.  The clock is never advanced past the
+start or end of a time-triggered fault.
+
+To the guest this looks as if the host had descheduled it for the skipped
+time; with @option{-icount}, it is as if the skipped instructions had taken
+no time.
+ETEXI
+
+DEF("superblocks", HAS_ARG, QEMU_OPTION_superblocks, \
+    "-superblocks n\n" \
+    "                retranslate code executed n times across conditional\n" \
+    "                branches\n", QEMU_ARCH_ARM)
+STEXI
+@item -superblocks @var{n}
+@findex -superblocks
+Count how often each translated block is executed and in which direction it
+leaves through its final conditional branch.  After @var{n} executions the
+block is translated again as a superblock that follows the usual direction
+of up to eight conditional branches on the same guest page, with a side exit
+for the other direction.  Hot loops then run without returning to the main
+loop between their basic blocks.  Blocks are not chained to each other while
+they are being counted.  Superblocks are not formed while CPU or register
+faults are loaded, and the option cannot be combined with @option{-icount}.
+ETEXI
+
+DEF("tb-prefetch", HAS_ARG, QEMU_OPTION_tb_prefetch, \
+    "-tb-prefetch n\n" \
+    "                translate up to n queued branch targets while the CPU\n" \
+    "                is halted\n", QEMU_ARCH_ARM)
+STEXI
+@item -tb-prefetch @var{n}
+@findex -tb-prefetch
+Queue the targets of the direct branches of every newly translated block,
+keeping the @var{n} most recent ones, and translate them while the CPU is
+halted (e.g. in @code{WFI}) waiting for an interrupt.  The targets of these
+blocks are queued in turn, so the code reachable from what has already run
+is translated before it is reached.  Only code on pages that are mapped in
+the TLB is translated, and only while the region of the translation buffer
+that is being filled is less than half full.  @code{info jit} shows the
+number of blocks translated ahead and how many of them were run later.
+Only the ARM translator records branch targets, so the option is only
+available for ARM targets.
+ETEXI
+
 DEF("watchdog", HAS_ARG, QEMU_OPTION_watchdog, \
     "-watchdog i6300esb|ib700\n" \
     "                enable virtual hardware watchdog [default=none]\n",
@@ -2990,6 +3119,24 @@ STEXI
 @findex -semihosting
 Semihosting mode (ARM, M68K, Xtensa only).
 ETEXI
+DEF("semihosting-console", HAS_ARG, QEMU_OPTION_semihosting_console,
+    "-semihosting-console [golden=file][,output=file|none][,stop=on|off]\n"
+    "                buffer semihosting console output and compare it\n"
+    "                against a golden output\n", QEMU_ARCH_ARM)
+STEXI
+@item -semihosting-console [golden=@var{file}][,output=@var{file}|none][,stop=on|off]
+@findex -semihosting-console
+Keep the semihosting console output of the guest (@code{SYS_WRITEC},
+@code{SYS_WRITE0} and @code{SYS_WRITE} to @code{:tt}) in memory instead of
+writing every call to the host, and write it to @var{file} (default: stderr,
+@code{none} to discard it) at exit (ARM only).
+
+With @option{golden}, the output is compared with the contents of
+@var{file} as it is written. The first differing byte, or a different
+length at guest exit, marks the experiment as silent data corruption in the
+@option{-fi-campaign} record; with @option{stop=on} the experiment is
+stopped right away.
+ETEXI
 DEF("old-param", 0, QEMU_OPTION_old_param,
     "-old-param      old param mode\n", QEMU_ARCH_ARM)
 STEXI
@@ -673,7 +673,8 @@ migrate-set-cache-size
 ----------------------
 
 Set cache size to be used by XBZRLE migration, the cache size will be rounded
-down to the nearest power of 2
+down to the nearest power of 2.  During a migration the cache is resized
+before the next iteration, and the pages that are cached are kept
 
 Arguments:
 
@@ -1770,6 +1771,30 @@ EQMP
         .mhandler.cmd_new = qmp_marshal_input_query_faults,
     },
 
+SQMP
+fault-rollback
+--------------
+
+Restore guest RAM, the device and the CPU state saved by -fi-journal.
+A machine that has shut down is paused afterwards.
+If the device state cannot be restored, the machine is stopped with the
+status "internal-error" until it is reset.
+
+Arguments: None.
+
+Example:
+
+-> { "execute": "fault-rollback" }
+<- { "return": {} }
+
+EQMP
+
+    {
+        .name       = "fault-rollback",
+        .args_type  = "",
+        .mhandler.cmd_new = qmp_marshal_input_fault_rollback,
+    },
+
 SQMP
 query-commands
 --------------
@@ -2832,6 +2857,7 @@ The main json-object contains the following:
          - "bytes": number of bytes transferred for XBZRLE compressed pages
          - "pages": number of XBZRLE compressed pages
          - "cache-miss": number of XBRZRLE page cache misses
+         - "cache-hit": number of XBRZRLE page cache hits
          - "overflow": number of times XBZRLE overflows.  This means
            that the XBZRLE encoding was bigger than just sent the
            whole page, and then we sent the whole page instead (as as
@@ -2936,6 +2962,7 @@ Examples:
             "bytes":20971520,
             "pages":2444343,
             "cache-miss":2244,
+            "cache-hit":2439876,
             "overflow":34434
          }
       }
@@ -2477,6 +2477,61 @@ void qmp_xen_save_devices_state(const char *filename, Error **errp)
         vm_start();
 }
 
+/* Device state kept in memory (e.g. by the FIES rollback journal) */
+static int mem_put_buffer(void *opaque, const uint8_t *buf,
+                          int64_t pos, int size)
+{
+    g_byte_array_append(opaque, buf, size);
+    return size;
+}
+
+static int mem_get_buffer(void *opaque, uint8_t *buf, int64_t pos, int size)
+{
+    GByteArray *state = opaque;
+
+    if (pos >= state->len) {
+        return 0;
+    }
+    size = MIN(size, state->len - pos);
+    memcpy(buf, state->data + pos, size);
+    return size;
+}
+
+static const QEMUFileOps mem_read_ops = {
+    .get_buffer = mem_get_buffer,
+};
+
+static const QEMUFileOps mem_write_ops = {
+    .put_buffer = mem_put_buffer,
+};
+
+/* Save the state of all devices but RAM; returns NULL on error */
+GByteArray *qemu_save_device_state_mem(void)
+{
+    GByteArray *state = g_byte_array_new();
+    QEMUFile *f;
+    int ret;
+
+    f = qemu_fopen_ops(state, &mem_write_ops);
+    ret = qemu_save_device_state(f);
+    if (qemu_fclose(f) < 0 || ret < 0) {
+        g_byte_array_free(state, TRUE);
+        return NULL;
+    }
+    return state;
+}
+
+int qemu_load_device_state_mem(GByteArray *state)
+{
+    QEMUFile *f;
+    int ret;
+
+    f = qemu_fopen_ops(state, &mem_read_ops);
+    ret = qemu_loadvm_state(f);
+    qemu_fclose(f);
+    return ret;
+}
+
 int load_vmstate(const char *name)
 {
     BlockDriverState *bs, *bs_vm_state;
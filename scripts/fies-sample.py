@@ -0,0 +1,406 @@
+#!/usr/bin/env python
+#
+# Statistical fault sampling for FIES campaigns
+#
+# Samples single faults from a fault space, runs one FIES experiment per
+# fault and keeps a confidence interval on the diagnostic coverage of every
+# stratum of the fault space.  A stratum stops being sampled once the
+# interval is narrower than the requested precision.
+#
+# Usage: fies-sample.py [options] SPACE.xml -- qemu-system-arm ARGS...
+#
+# The fault space uses the vocabulary of the fault library, with ranges
+# where a single value would be:
+#
+#   <faultspace>
+#     <stratum name="ram-bitflip">
+#       <component>RAM</component>
+#       <target>MEMORY CELL</target>
+#       <mode>BIT-FLIP</mode>
+#       <trigger>TIME</trigger>
+#       <type>TRANSIENT</type>
+#       <timer>1MS-500MS</timer>
+#       <duration>1MS</duration>
+#       <params>
+#         <address step="4">0x40000000-0x4001fffc</address>
+#         <mask sample="bit">0xffffffff</mask>
+#       </params>
+#     </stratum>
+#   </faultspace>
+#
+# Ranges are sampled uniformly; <mask sample="bit"> picks one of the set
+# bits of the mask.  Every other element is copied to the fault unchanged.
+#
+# Diagnostic coverage is the share of activated, not masked faults that
+# were detected, as in 'info faults'.
+#
+# This work is licensed under the terms of the GNU GPL, version 2 or later.
+# See the COPYING file in the top-level directory.
+
+from __future__ import print_function
+
+import json
+import math
+import optparse
+import os
+import random
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+import xml.etree.ElementTree as ET
+
+OUTCOMES = ['masked', 'detected', 'sdc', 'hang', 'crash']
+
+# a range of integers, optionally with a time unit, e.g. 0x100-0x1ff or 1MS-5MS
+RANGE_RE = re.compile(r'^\s*(0x[0-9a-fA-F]+|\d+)\s*([A-Za-z]*)\s*-'
+                      r'\s*(0x[0-9a-fA-F]+|\d+)\s*([A-Za-z]*)\s*$')
+
+
+# --- confidence intervals ---------------------------------------------------
+
+def normal_quantile(p):
+    '''Inverse of the standard normal CDF, by bisection.'''
+    lo, hi = -10.0, 10.0
+    for i in range(100):
+        mid = (lo + hi) / 2
+        if 0.5 * (1 + math.erf(mid / math.sqrt(2))) < p:
+            lo = mid
+        else:
+            hi = mid
+    return (lo + hi) / 2
+
+
+def wilson_interval(k, n, confidence):
+    if n == 0:
+        return 0.0, 1.0
+    z = normal_quantile(1 - (1 - confidence) / 2)
+    p = float(k) / n
+    denom = 1 + z * z / n
+    centre = (p + z * z / (2 * n)) / denom
+    half = z * math.sqrt(p * (1 - p) / n + z * z / (4 * n * n)) / denom
+    return max(0.0, centre - half), min(1.0, centre + half)
+
+
+def betacf(a, b, x):
+    '''Continued fraction for the incomplete beta function.'''
+    tiny = 1e-300
+    qab, qap, qam = a + b, a + 1, a - 1
+    c, d = 1.0, 1 - qab * x / qap
+    d = 1 / (d if abs(d) > tiny else tiny)
+    h = d
+    for m in range(1, 300):
+        m2 = 2 * m
+        aa = m * (b - m) * x / ((qam + m2) * (a + m2))
+        d = 1 + aa * d
+        d = 1 / (d if abs(d) > tiny else tiny)
+        c = 1 + aa / c
+        c = c if abs(c) > tiny else tiny
+        h *= d * c
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2))
+        d = 1 + aa * d
+        d = 1 / (d if abs(d) > tiny else tiny)
+        c = 1 + aa / c
+        c = c if abs(c) > tiny else tiny
+        delta = d * c
+        h *= delta
+        if abs(delta - 1) < 1e-12:
+            break
+    return h
+
+
+def betainc(a, b, x):
+    '''Regularized incomplete beta function I_x(a, b).'''
+    if x <= 0:
+        return 0.0
+    if x >= 1:
+        return 1.0
+    lbeta = math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b)
+    front = math.exp(lbeta + a * math.log(x) + b * math.log(1 - x))
+    if x < (a + 1) / (a + b + 2):
+        return front * betacf(a, b, x) / a
+    return 1 - front * betacf(b, a, 1 - x) / b
+
+
+def beta_quantile(p, a, b):
+    lo, hi = 0.0, 1.0
+    for i in range(100):
+        mid = (lo + hi) / 2
+        if betainc(a, b, mid) < p:
+            lo = mid
+        else:
+            hi = mid
+    return (lo + hi) / 2
+
+
+def clopper_pearson_interval(k, n, confidence):
+    if n == 0:
+        return 0.0, 1.0
+    alpha = 1 - confidence
+    lower = 0.0 if k == 0 else beta_quantile(alpha / 2, k, n - k + 1)
+    upper = 1.0 if k == n else beta_quantile(1 - alpha / 2, k + 1, n - k)
+    return lower, upper
+
+
+INTERVALS = {
+    'wilson': wilson_interval,
+    'clopper-pearson': clopper_pearson_interval,
+}
+
+
+# --- fault space ------------------------------------------------------------
+
+def parse_int(text):
+    return int(text.strip(), 0)
+
+
+def sample_value(elem, rng):
+    '''Returns the text for one sampled value of a fault space element.'''
+    text = (elem.text or '').strip()
+    if elem.get('sample') == 'bit':
+        mask = parse_int(text)
+        bits = [i for i in range(64) if mask & (1 << i)]
+        if not bits:
+            raise ValueError('<%s> has no bit set' % elem.tag)
+        return '0x%x' % (1 << rng.choice(bits))
+
+    m = RANGE_RE.match(text)
+    if not m:
+        return text
+
+    if m.group(2) != m.group(4):
+        raise ValueError('<%s>: both ends of %s need the same unit' %
+                         (elem.tag, text))
+    lo, hi = parse_int(m.group(1)), parse_int(m.group(3))
+    step = parse_int(elem.get('step', '1'))
+    value = lo + step * rng.randint(0, (hi - lo) // step)
+    if text.startswith('0x'):
+        return '0x%x%s' % (value, m.group(2))
+    return '%d%s' % (value, m.group(2))
+
+
+class Stratum(object):
+    def __init__(self, elem, index):
+        self.elem = elem
+        self.name = elem.get('name') or '%s/%s/%s' % (
+            elem.findtext('component', '?'), elem.findtext('target', '?'),
+            elem.findtext('mode', '?'))
+        self.index = index
+        self.experiments = 0
+        self.running = 0
+        self.not_activated = 0
+        self.outcomes = dict((o, 0) for o in OUTCOMES)
+        self.done = False
+
+    def dangerous(self):
+        return sum(self.outcomes[o] for o in OUTCOMES if o != 'masked')
+
+    def sample(self, fault_id, rng):
+        '''Returns the fault library XML of one sampled fault.'''
+        lines = ['\t<fault>', '\t\t<id>%d</id>' % fault_id]
+        for child in self.elem:
+            if child.tag == 'params':
+                lines.append('\t\t<params>')
+                for param in child:
+                    lines.append('\t\t\t<%s>%s</%s>' %
+                                 (param.tag, sample_value(param, rng),
+                                  param.tag))
+                lines.append('\t\t</params>')
+            elif child.tag != 'id':
+                lines.append('\t\t<%s>%s</%s>' %
+                             (child.tag, sample_value(child, rng), child.tag))
+        lines.append('\t</fault>')
+        return '\n'.join(lines) + '\n'
+
+
+def load_fault_space(path):
+    root = ET.parse(path).getroot()
+    strata = [Stratum(e, i) for i, e in enumerate(root.findall('stratum'))]
+    if not strata:
+        raise ValueError('%s: no <stratum> found' % path)
+    return strata
+
+
+# --- campaign ---------------------------------------------------------------
+
+class CampaignReader(object):
+    '''Reads the records appended to a campaign file since the last call.'''
+
+    def __init__(self, path):
+        self.path = path
+        self.offset = 0
+
+    def new_records(self):
+        records = []
+        if not os.path.exists(self.path):
+            return records
+        with open(self.path, 'rb') as f:
+            f.seek(self.offset)
+            for line in f:
+                if not line.endswith(b'\n'):
+                    break
+                self.offset += len(line)
+                line = line.decode('utf-8', 'replace').rstrip('\n')
+                if line.startswith('#'):
+                    continue
+                fields = line.split('\t')
+                if len(fields) == 13:
+                    records.append(fields)
+        return records
+
+    def last_experiment(self):
+        last = -1
+        for fields in self.new_records():
+            last = max(last, int(fields[0]))
+        return last
+
+
+def main():
+    parser = optparse.OptionParser(
+        usage='%prog [options] SPACE.xml -- QEMU [ARGS...]')
+    parser.add_option('--campaign', default='campaign.tsv',
+                      help='campaign file the experiments append to')
+    parser.add_option('--precision', type='float', default=0.05,
+                      help='stop a stratum when the half width of the '
+                      'coverage interval is at most this (default 0.05)')
+    parser.add_option('--confidence', type='float', default=0.95,
+                      help='confidence level of the intervals (default 0.95)')
+    parser.add_option('--interval', choices=sorted(INTERVALS.keys()),
+                      default='clopper-pearson',
+                      help='wilson or clopper-pearson (default)')
+    parser.add_option('--min-samples', type='int', default=10,
+                      help='minimum number of not masked activated faults '
+                      'per stratum before stopping (default 10)')
+    parser.add_option('--max-experiments', type='int', default=10000,
+                      help='maximum number of experiments per stratum')
+    parser.add_option('--insn-limit', type='int', default=0,
+                      help='guest instruction limit of each experiment')
+    parser.add_option('--jobs', '-j', type='int', default=1,
+                      help='number of experiments run in parallel')
+    parser.add_option('--seed', type='int', default=None,
+                      help='random seed')
+    parser.add_option('--output', default='-',
+                      help='JSON summary file (default: stdout)')
+    opts, args = parser.parse_args()
+
+    if len(args) < 2:
+        parser.error('need a fault space and a QEMU command line')
+    strata = load_fault_space(args[0])
+    qemu_args = args[1:]
+    interval = INTERVALS[opts.interval]
+    rng = random.Random(opts.seed)
+
+    reader = CampaignReader(opts.campaign)
+    next_experiment = reader.last_experiment() + 1
+    workdir = tempfile.mkdtemp(prefix='fies-sample-')
+    running = {}    # experiment -> (process, stratum, fault library)
+    experiment_stratum = {}
+
+    def update(stratum):
+        k, n = stratum.outcomes['detected'], stratum.dangerous()
+        lo, hi = interval(k, n, opts.confidence)
+        if (n >= opts.min_samples and (hi - lo) / 2 <= opts.precision) or \
+                stratum.experiments >= opts.max_experiments:
+            stratum.done = True
+
+    def collect():
+        for fields in reader.new_records():
+            stratum = experiment_stratum.pop(int(fields[0]), None)
+            if stratum is None:
+                continue
+            if int(fields[9]) == 0:
+                stratum.not_activated += 1
+            elif fields[10] in stratum.outcomes:
+                stratum.outcomes[fields[10]] += 1
+            update(stratum)
+
+    try:
+        while True:
+            # start experiments for the strata that still need samples,
+            # round robin
+            pending = [s for s in strata if not s.done and
+                       s.experiments + s.running < opts.max_experiments]
+            while pending and len(running) < opts.jobs:
+                stratum = min(pending, key=lambda s: s.experiments + s.running)
+                lib = os.path.join(workdir, '%d.xml' % next_experiment)
+                with open(lib, 'w') as f:
+                    f.write('<?xml version="1.0" encoding="UTF-8"?>\n'
+                            '<injection>\n')
+                    f.write(stratum.sample(1, rng))
+                    f.write('</injection>\n')
+                campaign = 'file=%s,experiment=%d' % (opts.campaign,
+                                                      next_experiment)
+                if opts.insn_limit:
+                    campaign += ',insn-limit=%d' % opts.insn_limit
+                proc = subprocess.Popen(qemu_args + ['-fi', lib,
+                                                     '-fi-campaign', campaign],
+                                        stdout=open(os.devnull, 'w'))
+                running[next_experiment] = (proc, stratum, lib)
+                experiment_stratum[next_experiment] = stratum
+                stratum.running += 1
+                next_experiment += 1
+                pending = [s for s in pending if
+                           s.experiments + s.running < opts.max_experiments]
+
+            if not running:
+                break
+
+            time.sleep(0.05)
+            for experiment, (proc, stratum, lib) in list(running.items()):
+                if proc.poll() is None:
+                    continue
+                del running[experiment]
+                os.unlink(lib)
+                stratum.running -= 1
+                stratum.experiments += 1
+            collect()
+            # an experiment that died without a record counts as a crash
+            for experiment in list(experiment_stratum.keys()):
+                if experiment not in running:
+                    stratum = experiment_stratum.pop(experiment)
+                    stratum.outcomes['crash'] += 1
+                    update(stratum)
+            if all(s.done for s in strata) and not running:
+                break
+    finally:
+        for proc, stratum, lib in running.values():
+            proc.kill()
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    summary = []
+    for s in strata:
+        k, n = s.outcomes['detected'], s.dangerous()
+        lo, hi = interval(k, n, opts.confidence)
+        entry = {
+            'stratum': s.name,
+            'experiments': s.experiments,
+            'not_activated': s.not_activated,
+            'coverage': float(k) / n if n else None,
+            'interval': [lo, hi],
+            'converged': n >= opts.min_samples and
+            (hi - lo) / 2 <= opts.precision,
+        }
+        entry.update(s.outcomes)
+        summary.append(entry)
+        print('%-32s %6d experiments, DC %s [%.3f, %.3f]' %
+              (s.name, s.experiments,
+               '%.3f' % entry['coverage'] if n else '  -  ', lo, hi),
+              file=sys.stderr)
+
+    text = json.dumps({'campaign': opts.campaign,
+                       'confidence': opts.confidence,
+                       'interval': opts.interval,
+                       'precision': opts.precision,
+                       'strata': summary}, indent=2, sort_keys=True)
+    if opts.output == '-':
+        print(text)
+    else:
+        with open(opts.output, 'w') as f:
+            f.write(text + '\n')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
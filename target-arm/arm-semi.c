@@ -35,6 +35,7 @@
 #include "qemu-common.h"
 #include "exec/gdbstub.h"
 #include "hw/arm/arm.h"
+#include "fault-injection-campaign.h"
 #endif
 
 #define TARGET_SYS_OPEN        0x01
@@ -114,6 +115,8 @@ static inline uint32_t set_swi_errno(CPUARMState *env, uint32_t code)
 }
 
 #include "exec/softmmu-semi.h"
+#include "qemu/option.h"
+#include "sysemu/sysemu.h"
 #endif
 
 static target_ulong arm_semi_syscall_len;
@@ -180,6 +183,166 @@ static void arm_semi_flen_cb(CPUState *cs, target_ulong ret, target_ulong err)
 } while (0)
 
 #define SET_ARG(n, val) put_user_ual(val, args + (n) * 4)
+
+#if !defined(CONFIG_USER_ONLY)
+/* Console output is kept in memory and only written to the host at exit,
+ * or when ARM_SEMI_CONSOLE_MAX_BUFFER bytes have accumulated.  With a
+ * golden output it is compared as it arrives.  */
+#define ARM_SEMI_CONSOLE_MAX_BUFFER (1 << 20)
+
+typedef struct ArmSemiConsole {
+    bool initialized;
+    bool enabled;
+    GString *buf;
+    int out_fd;
+    bool stop;
+    gchar *golden;
+    gsize golden_len;
+    gsize pos;
+    bool diverged;
+    gsize diverged_at;
+} ArmSemiConsole;
+
+static ArmSemiConsole arm_semi_console;
+
+static void arm_semi_console_flush(void)
+{
+    ArmSemiConsole *con = &arm_semi_console;
+    gsize done = 0;
+    ssize_t ret;
+
+    while (con->out_fd >= 0 && done < con->buf->len) {
+        ret = write(con->out_fd, con->buf->str + done, con->buf->len - done);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            break;
+        }
+        done += ret;
+    }
+    g_string_truncate(con->buf, 0);
+}
+
+static void arm_semi_console_exit(void)
+{
+    ArmSemiConsole *con = &arm_semi_console;
+
+    arm_semi_console_flush();
+    if (con->diverged) {
+        fprintf(stderr, "semihosting: console output diverges from the "
+                "golden output at byte %" PRIu64 "\n",
+                (uint64_t)con->diverged_at);
+    }
+}
+
+static void arm_semi_console_init(void)
+{
+    ArmSemiConsole *con = &arm_semi_console;
+    char buf[1024];
+    GError *err = NULL;
+
+    con->initialized = true;
+    if (!semihosting_console) {
+        return;
+    }
+
+    con->enabled = true;
+    con->buf = g_string_sized_new(4096);
+    con->out_fd = STDERR_FILENO;
+    if (get_param_value(buf, sizeof(buf), "output", semihosting_console)) {
+        if (!strcmp(buf, "none")) {
+            con->out_fd = -1;
+        } else {
+            con->out_fd = qemu_open(buf, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (con->out_fd < 0) {
+                fprintf(stderr, "semihosting: cannot open %s: %s\n",
+                        buf, strerror(errno));
+                exit(1);
+            }
+        }
+    }
+    if (get_param_value(buf, sizeof(buf), "golden", semihosting_console)) {
+        if (!g_file_get_contents(buf, &con->golden, &con->golden_len, &err)) {
+            fprintf(stderr, "semihosting: %s\n", err->message);
+            exit(1);
+        }
+    }
+    if (get_param_value(buf, sizeof(buf), "stop", semihosting_console)) {
+        con->stop = !strcmp(buf, "on");
+    }
+    atexit(arm_semi_console_exit);
+}
+
+static void arm_semi_console_diverged(gsize offset)
+{
+    ArmSemiConsole *con = &arm_semi_console;
+
+    con->diverged = true;
+    con->diverged_at = offset;
+    fies_campaign_set_outcome(FIES_OUTCOME_SDC);
+    if (con->stop) {
+        qemu_system_shutdown_request();
+    }
+}
+
+/* Returns false if the console is not captured and the caller should
+   write to the host itself.  */
+static bool arm_semi_console_write(const char *s, gsize len)
+{
+    ArmSemiConsole *con = &arm_semi_console;
+    gsize i, n;
+
+    if (!con->initialized) {
+        arm_semi_console_init();
+    }
+    if (!con->enabled) {
+        return false;
+    }
+
+    if (con->golden && !con->diverged) {
+        n = MIN(len, con->golden_len - con->pos);
+        if (memcmp(s, con->golden + con->pos, n)) {
+            for (i = 0; s[i] == con->golden[con->pos + i]; i++) {
+                /* find the first differing byte */
+            }
+            arm_semi_console_diverged(con->pos + i);
+        } else if (n < len) {
+            arm_semi_console_diverged(con->golden_len);
+        }
+    }
+    con->pos += len;
+
+    g_string_append_len(con->buf, s, len);
+    if (con->buf->len >= ARM_SEMI_CONSOLE_MAX_BUFFER) {
+        arm_semi_console_flush();
+    }
+    return true;
+}
+
+/* Output that ends early also differs from the golden output.  */
+static void arm_semi_console_guest_exit(void)
+{
+    ArmSemiConsole *con = &arm_semi_console;
+
+    if (!con->initialized) {
+        arm_semi_console_init();
+    }
+    if (con->golden && !con->diverged && con->pos < con->golden_len) {
+        arm_semi_console_diverged(con->pos);
+    }
+}
+#else
+static bool arm_semi_console_write(const char *s, gsize len)
+{
+    return false;
+}
+
+static void arm_semi_console_guest_exit(void)
+{
+}
+#endif
+
 uint32_t do_arm_semihosting(CPUARMState *env)
 {
     ARMCPU *cpu = arm_env_get_cpu(env);
@@ -244,6 +407,8 @@ uint32_t do_arm_semihosting(CPUARMState *env)
           if (use_gdb_syscalls()) {
                 gdb_do_syscall(arm_semi_cb, "write,2,%x,1", args);
                 return env->regs[0];
+          } else if (arm_semi_console_write(&c, 1)) {
+                return 1;
           } else {
                 return write(STDERR_FILENO, &c, 1);
           }
@@ -256,6 +421,8 @@ uint32_t do_arm_semihosting(CPUARMState *env)
         if (use_gdb_syscalls()) {
             gdb_do_syscall(arm_semi_cb, "write,2,%x,%x\n", args, len);
             ret = env->regs[0];
+        } else if (arm_semi_console_write(s, len)) {
+            ret = len;
         } else {
             ret = write(STDERR_FILENO, s, len);
         }
@@ -276,7 +443,12 @@ uint32_t do_arm_semihosting(CPUARMState *env)
                 /* FIXME - should this error code be -TARGET_EFAULT ? */
                 return (uint32_t)-1;
             }
-            ret = set_swi_errno(ts, write(arg0, s, len));
+            if ((arg0 == STDOUT_FILENO || arg0 == STDERR_FILENO) &&
+                arm_semi_console_write(s, len)) {
+                ret = len;
+            } else {
+                ret = set_swi_errno(ts, write(arg0, s, len));
+            }
             unlock_user(s, arg1, 0);
             if (ret == (uint32_t)-1)
                 return -1;
@@ -550,6 +722,8 @@ uint32_t do_arm_semihosting(CPUARMState *env)
             return 0;
         }
     case TARGET_SYS_EXIT:
+        arm_semi_console_guest_exit();
+        fies_campaign_guest_exit(args);
         gdb_exit(env, 0);
         exit(0);
     default:
@@ -38,6 +38,8 @@
 #include "fpu/softfloat.h"
 
 #define TARGET_HAS_ICE 1
+/* The translator can continue TBs across conditional branches.  */
+#define TARGET_HAS_SUPERBLOCKS 1
 
 #define EXCP_UDEF            1   /* undefined instruction */
 #define EXCP_SWI             2   /* software interrupt */
@@ -296,6 +298,12 @@ typedef struct CPUARMState {
 
 ARMCPU *cpu_arm_init(const char *cpu_model);
 void arm_translate_init(void);
+
+/* Host SIMD support available to the whole Q register NEON helpers.  */
+#define NEON_HOST_SSE2  (1 << 0)
+#define NEON_HOST_SSSE3 (1 << 1)
+int neon_host_simd_features(void);
+
 void arm_cpu_register_gdb_regs_for_features(ARMCPU *cpu);
 int cpu_arm_exec(CPUARMState *s);
 int bank_number(int mode);
@@ -5,6 +5,8 @@
 #include "sysemu/arch_init.h"
 #include "sysemu/sysemu.h"
 #include "qemu/bitops.h"
+#include "vfp_hostfp.h"
+#include "fault-injection-campaign.h"
 
 extern char is_safe_rtos;
 
@@ -2406,6 +2408,7 @@ void arm_cpu_do_interrupt(CPUState *cs)
     switch (env->exception_index) {
     case EXCP_UDEF:
     	//printf("\nEXCP_UDEF - arm_cpu_do_interrupt\n");
+        fies_campaign_guest_exception();
         new_mode = ARM_CPU_MODE_UND;
         addr = 0x04;
         mask = CPSR_I;
@@ -2458,6 +2461,7 @@ void arm_cpu_do_interrupt(CPUState *cs)
         /* Fall through to prefetch abort.  */
     case EXCP_PREFETCH_ABORT:
     	//printf("\nEXCP_PREFETCH_ABORT - arm_cpu_do_interrupt\n");
+        fies_campaign_guest_exception();
         qemu_log_mask(CPU_LOG_INT, "...with IFSR 0x%x IFAR 0x%x\n",
                       env->cp15.c5_insn, env->cp15.c6_insn);
         new_mode = ARM_CPU_MODE_ABT;
@@ -2467,6 +2471,7 @@ void arm_cpu_do_interrupt(CPUState *cs)
         break;
     case EXCP_DATA_ABORT:
     	//printf("\nEXCP_DATA_ABORT - arm_cpu_do_interrupt\n");
+        fies_campaign_guest_exception();
         qemu_log_mask(CPU_LOG_INT, "...with DFSR 0x%x DFAR 0x%x\n",
                       env->cp15.c5_data, env->cp15.c6_data);
         new_mode = ARM_CPU_MODE_ABT;
@@ -3629,15 +3634,24 @@ void vfp_set_fpscr(CPUARMState *env, uint32_t val)
 
 #define VFP_HELPER(name, p) HELPER(glue(glue(vfp_,name),p))
 
+/* Try the host FPU first; see vfp_hostfp.h for when it is exact.  */
 #define VFP_BINOP(name) \
 float32 VFP_HELPER(name, s)(float32 a, float32 b, void *fpstp) \
 { \
     float_status *fpst = fpstp; \
+    float32 r; \
+    if (vfp_hostfp_ ## name ## s(a, b, &r, fpst)) { \
+        return r; \
+    } \
     return float32_ ## name(a, b, fpst); \
 } \
 float64 VFP_HELPER(name, d)(float64 a, float64 b, void *fpstp) \
 { \
     float_status *fpst = fpstp; \
+    float64 r; \
+    if (vfp_hostfp_ ## name ## d(a, b, &r, fpst)) { \
+        return r; \
+    } \
     return float64_ ## name(a, b, fpst); \
 }
 VFP_BINOP(add)
@@ -13,6 +13,17 @@
 #include "exec/exec-all.h"
 #include "helper.h"
 
+/* The SSE2/SSSE3 versions of the whole Q register helpers are built with
+   target() attributes and chosen at runtime, so they do not depend on the
+   -march of the build.  */
+#if (defined(__i386__) || defined(__x86_64__)) && QEMU_GNUC_PREREQ(4, 9)
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#define NEON_QREG_SIMD
+#define NEON_QREG_SSE2 __attribute__((target("sse2")))
+#define NEON_QREG_SSSE3 __attribute__((target("ssse3")))
+#endif
+
 #define SIGNBIT (uint32_t)0x80000000
 #define SIGNBIT64 ((uint64_t)1 << 63)
 
@@ -2008,3 +2019,328 @@ void HELPER(neon_zip16)(CPUARMState *env, uint32_t rd, uint32_t rm)
     env->vfp.regs[rm] = make_float64(m0);
     env->vfp.regs[rd] = make_float64(d0);
 }
+
+/* Whole Q register versions of the common integer ops.  Register arguments
+ * are D register numbers, as for the zip/unzip helpers above.  On x86 hosts
+ * with SSE2 (and SSSE3 for VABS) they use SIMD; the translator only calls
+ * them when neon_host_simd_features() says so, since the portable lane
+ * loops, which every helper falls back to, would be slower than the
+ * per-pass code.
+ */
+static int neon_qreg_features;
+
+#ifdef NEON_QREG_SIMD
+static void __attribute__((constructor)) neon_qreg_init(void)
+{
+    /* __builtin_cpu_supports() is not ready yet in constructors */
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        neon_qreg_features |= NEON_HOST_SSE2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        neon_qreg_features |= NEON_HOST_SSSE3;
+    }
+}
+
+/* Run the SIMD version of the helper if the host has FEATURE */
+#define NEON_QREG_DISPATCH(feature, name, ...) do { \
+    if (neon_qreg_features & (feature)) { \
+        neon_qreg_##name##_simd(env, __VA_ARGS__); \
+        return; \
+    } \
+} while (0)
+#else
+#define NEON_QREG_DISPATCH(feature, name, ...) do { } while (0)
+#endif
+
+int neon_host_simd_features(void)
+{
+    return neon_qreg_features;
+}
+
+#define QREG_MASK(esize) (~0ULL >> (64 - (esize)))
+
+/* Portable fallback: apply EXPR to every lane of a and b.  */
+#define NEON_QREG_LANES(esize, type, EXPR) do { \
+    int h_, i_; \
+    for (h_ = 0; h_ < 2; h_++) { \
+        uint64_t va_ = float64_val(env->vfp.regs[rn + h_]); \
+        uint64_t vb_ = float64_val(env->vfp.regs[rm + h_]); \
+        uint64_t r_ = 0; \
+        for (i_ = 0; i_ < 64 / (esize); i_++) { \
+            type a = va_ >> (i_ * (esize)); \
+            type b = vb_ >> (i_ * (esize)); \
+            r_ |= ((uint64_t)(EXPR) & QREG_MASK(esize)) << (i_ * (esize)); \
+        } \
+        env->vfp.regs[rd + h_] = make_float64(r_); \
+    } \
+} while (0)
+
+#define NEON_QREG_LANES1(esize, type, EXPR) do { \
+    int h_, i_; \
+    for (h_ = 0; h_ < 2; h_++) { \
+        uint64_t va_ = float64_val(env->vfp.regs[rm + h_]); \
+        uint64_t r_ = 0; \
+        for (i_ = 0; i_ < 64 / (esize); i_++) { \
+            type a = va_ >> (i_ * (esize)); \
+            r_ |= ((uint64_t)(EXPR) & QREG_MASK(esize)) << (i_ * (esize)); \
+        } \
+        env->vfp.regs[rd + h_] = make_float64(r_); \
+    } \
+} while (0)
+
+static inline int64_t neon_qreg_sat(CPUARMState *env, int64_t v,
+                                    int64_t min, int64_t max)
+{
+    if (v < min) {
+        SET_QC();
+        return min;
+    }
+    if (v > max) {
+        SET_QC();
+        return max;
+    }
+    return v;
+}
+
+#ifdef NEON_QREG_SIMD
+/* Little-endian host, so the two D registers of a Q register are laid
+   out as a single 128-bit vector with lane 0 first.  */
+static inline NEON_QREG_SSE2 __m128i neon_qreg_load(CPUARMState *env, uint32_t reg)
+{
+    return _mm_loadu_si128((const __m128i *)&env->vfp.regs[reg]);
+}
+
+static inline NEON_QREG_SSE2 void neon_qreg_store(CPUARMState *env,
+                                                  uint32_t reg, __m128i v)
+{
+    _mm_storeu_si128((__m128i *)&env->vfp.regs[reg], v);
+}
+
+/* The saturating instructions have no flag output; set QC if the
+   saturated result differs from the wrapped one.  */
+static inline NEON_QREG_SSE2 __m128i neon_qreg_qc(CPUARMState *env,
+                                                  __m128i sat, __m128i wrap)
+{
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(sat, wrap)) != 0xffff) {
+        SET_QC();
+    }
+    return sat;
+}
+
+static inline NEON_QREG_SSE2 __m128i neon_qreg_not(__m128i a)
+{
+    return _mm_xor_si128(a, _mm_set1_epi32(-1));
+}
+
+static inline NEON_QREG_SSE2 __m128i neon_qreg_sel(__m128i mask, __m128i a,
+                                                   __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/* SSE2 only has signed compares; bias both sides for unsigned ones.  */
+static inline NEON_QREG_SSE2 __m128i neon_qreg_cgt_u8(__m128i a, __m128i b)
+{
+    __m128i bias = _mm_set1_epi8((char)0x80);
+    return _mm_cmpgt_epi8(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+static inline NEON_QREG_SSE2 __m128i neon_qreg_cgt_u16(__m128i a, __m128i b)
+{
+    __m128i bias = _mm_set1_epi16((short)0x8000);
+    return _mm_cmpgt_epi16(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+static inline NEON_QREG_SSE2 __m128i neon_qreg_cgt_u32(__m128i a, __m128i b)
+{
+    __m128i bias = _mm_set1_epi32(0x80000000);
+    return _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+static inline NEON_QREG_SSE2 __m128i neon_qreg_mul_8(__m128i a, __m128i b)
+{
+    __m128i even = _mm_and_si128(_mm_mullo_epi16(a, b), _mm_set1_epi16(0xff));
+    __m128i odd = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+    return _mm_or_si128(even, _mm_slli_epi16(odd, 8));
+}
+
+static inline NEON_QREG_SSE2 __m128i neon_qreg_mul_32(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+#define NEON_QREG_3OP_SIMD(name, SSE) \
+static NEON_QREG_SSE2 void neon_qreg_##name##_simd(CPUARMState *env, \
+                                                   uint32_t rd, uint32_t rn, \
+                                                   uint32_t rm) \
+{ \
+    __m128i a = neon_qreg_load(env, rn); \
+    __m128i b = neon_qreg_load(env, rm); \
+    neon_qreg_store(env, rd, SSE); \
+}
+
+#define NEON_QREG_SHIFT_SIMD(name, SSE) \
+static NEON_QREG_SSE2 void neon_qreg_##name##_simd(CPUARMState *env, \
+                                                   uint32_t rd, uint32_t rm, \
+                                                   uint32_t shift) \
+{ \
+    __m128i a = neon_qreg_load(env, rm); \
+    __m128i n = _mm_cvtsi32_si128(shift); \
+    neon_qreg_store(env, rd, SSE); \
+}
+
+#define NEON_QREG_ABS_SIMD(name, SSE) \
+static NEON_QREG_SSSE3 void neon_qreg_##name##_simd(CPUARMState *env, \
+                                                    uint32_t rd, uint32_t rm) \
+{ \
+    neon_qreg_store(env, rd, SSE(neon_qreg_load(env, rm))); \
+}
+#else
+#define NEON_QREG_3OP_SIMD(name, SSE)
+#define NEON_QREG_SHIFT_SIMD(name, SSE)
+#define NEON_QREG_ABS_SIMD(name, SSE)
+#endif
+
+#define NEON_QREG_3OP(name, esize, type, SSE, C) \
+NEON_QREG_3OP_SIMD(name, SSE) \
+void HELPER(neon_qreg_##name)(CPUARMState *env, uint32_t rd, \
+                              uint32_t rn, uint32_t rm) \
+{ \
+    NEON_QREG_DISPATCH(NEON_HOST_SSE2, name, rd, rn, rm); \
+    NEON_QREG_LANES(esize, type, C); \
+}
+
+#define NEON_QREG_SHIFT(name, esize, type, SSE, C) \
+NEON_QREG_SHIFT_SIMD(name, SSE) \
+void HELPER(neon_qreg_##name)(CPUARMState *env, uint32_t rd, \
+                              uint32_t rm, uint32_t shift) \
+{ \
+    NEON_QREG_DISPATCH(NEON_HOST_SSE2, name, rd, rm, shift); \
+    NEON_QREG_LANES1(esize, type, C); \
+}
+
+#define NEON_QREG_ABS(name, esize, type, SSE) \
+NEON_QREG_ABS_SIMD(name, SSE) \
+void HELPER(neon_qreg_##name)(CPUARMState *env, uint32_t rd, uint32_t rm) \
+{ \
+    NEON_QREG_DISPATCH(NEON_HOST_SSSE3, name, rd, rm); \
+    NEON_QREG_LANES1(esize, type, a < 0 ? -(int64_t)a : a); \
+}
+
+NEON_QREG_3OP(add_u8, 8, uint8_t, _mm_add_epi8(a, b), a + b)
+NEON_QREG_3OP(add_u16, 16, uint16_t, _mm_add_epi16(a, b), a + b)
+NEON_QREG_3OP(add_u32, 32, uint32_t, _mm_add_epi32(a, b), a + b)
+NEON_QREG_3OP(sub_u8, 8, uint8_t, _mm_sub_epi8(a, b), a - b)
+NEON_QREG_3OP(sub_u16, 16, uint16_t, _mm_sub_epi16(a, b), a - b)
+NEON_QREG_3OP(sub_u32, 32, uint32_t, _mm_sub_epi32(a, b), a - b)
+NEON_QREG_3OP(mul_u8, 8, uint8_t, neon_qreg_mul_8(a, b), a * b)
+NEON_QREG_3OP(mul_u16, 16, uint16_t, _mm_mullo_epi16(a, b), a * b)
+NEON_QREG_3OP(mul_u32, 32, uint32_t, neon_qreg_mul_32(a, b), a * b)
+
+NEON_QREG_3OP(qadd_s8, 8, int8_t,
+              neon_qreg_qc(env, _mm_adds_epi8(a, b), _mm_add_epi8(a, b)),
+              neon_qreg_sat(env, (int64_t)a + b, INT8_MIN, INT8_MAX))
+NEON_QREG_3OP(qadd_u8, 8, uint8_t,
+              neon_qreg_qc(env, _mm_adds_epu8(a, b), _mm_add_epi8(a, b)),
+              neon_qreg_sat(env, (int64_t)a + b, 0, UINT8_MAX))
+NEON_QREG_3OP(qadd_s16, 16, int16_t,
+              neon_qreg_qc(env, _mm_adds_epi16(a, b), _mm_add_epi16(a, b)),
+              neon_qreg_sat(env, (int64_t)a + b, INT16_MIN, INT16_MAX))
+NEON_QREG_3OP(qadd_u16, 16, uint16_t,
+              neon_qreg_qc(env, _mm_adds_epu16(a, b), _mm_add_epi16(a, b)),
+              neon_qreg_sat(env, (int64_t)a + b, 0, UINT16_MAX))
+NEON_QREG_3OP(qsub_s8, 8, int8_t,
+              neon_qreg_qc(env, _mm_subs_epi8(a, b), _mm_sub_epi8(a, b)),
+              neon_qreg_sat(env, (int64_t)a - b, INT8_MIN, INT8_MAX))
+NEON_QREG_3OP(qsub_u8, 8, uint8_t,
+              neon_qreg_qc(env, _mm_subs_epu8(a, b), _mm_sub_epi8(a, b)),
+              neon_qreg_sat(env, (int64_t)a - b, 0, UINT8_MAX))
+NEON_QREG_3OP(qsub_s16, 16, int16_t,
+              neon_qreg_qc(env, _mm_subs_epi16(a, b), _mm_sub_epi16(a, b)),
+              neon_qreg_sat(env, (int64_t)a - b, INT16_MIN, INT16_MAX))
+NEON_QREG_3OP(qsub_u16, 16, uint16_t,
+              neon_qreg_qc(env, _mm_subs_epu16(a, b), _mm_sub_epi16(a, b)),
+              neon_qreg_sat(env, (int64_t)a - b, 0, UINT16_MAX))
+
+NEON_QREG_3OP(ceq_u8, 8, uint8_t, _mm_cmpeq_epi8(a, b), -(a == b))
+NEON_QREG_3OP(ceq_u16, 16, uint16_t, _mm_cmpeq_epi16(a, b), -(a == b))
+NEON_QREG_3OP(ceq_u32, 32, uint32_t, _mm_cmpeq_epi32(a, b), -(a == b))
+NEON_QREG_3OP(tst_u8, 8, uint8_t,
+              neon_qreg_not(_mm_cmpeq_epi8(_mm_and_si128(a, b),
+                                           _mm_setzero_si128())),
+              -((a & b) != 0))
+NEON_QREG_3OP(tst_u16, 16, uint16_t,
+              neon_qreg_not(_mm_cmpeq_epi16(_mm_and_si128(a, b),
+                                            _mm_setzero_si128())),
+              -((a & b) != 0))
+NEON_QREG_3OP(tst_u32, 32, uint32_t,
+              neon_qreg_not(_mm_cmpeq_epi32(_mm_and_si128(a, b),
+                                            _mm_setzero_si128())),
+              -((a & b) != 0))
+
+NEON_QREG_3OP(cgt_s8, 8, int8_t, _mm_cmpgt_epi8(a, b), -(a > b))
+NEON_QREG_3OP(cgt_u8, 8, uint8_t, neon_qreg_cgt_u8(a, b), -(a > b))
+NEON_QREG_3OP(cgt_s16, 16, int16_t, _mm_cmpgt_epi16(a, b), -(a > b))
+NEON_QREG_3OP(cgt_u16, 16, uint16_t, neon_qreg_cgt_u16(a, b), -(a > b))
+NEON_QREG_3OP(cgt_s32, 32, int32_t, _mm_cmpgt_epi32(a, b), -(a > b))
+NEON_QREG_3OP(cgt_u32, 32, uint32_t, neon_qreg_cgt_u32(a, b), -(a > b))
+NEON_QREG_3OP(cge_s8, 8, int8_t,
+              neon_qreg_not(_mm_cmpgt_epi8(b, a)), -(a >= b))
+NEON_QREG_3OP(cge_u8, 8, uint8_t,
+              neon_qreg_not(neon_qreg_cgt_u8(b, a)), -(a >= b))
+NEON_QREG_3OP(cge_s16, 16, int16_t,
+              neon_qreg_not(_mm_cmpgt_epi16(b, a)), -(a >= b))
+NEON_QREG_3OP(cge_u16, 16, uint16_t,
+              neon_qreg_not(neon_qreg_cgt_u16(b, a)), -(a >= b))
+NEON_QREG_3OP(cge_s32, 32, int32_t,
+              neon_qreg_not(_mm_cmpgt_epi32(b, a)), -(a >= b))
+NEON_QREG_3OP(cge_u32, 32, uint32_t,
+              neon_qreg_not(neon_qreg_cgt_u32(b, a)), -(a >= b))
+
+NEON_QREG_3OP(max_s8, 8, int8_t,
+              neon_qreg_sel(_mm_cmpgt_epi8(a, b), a, b), a > b ? a : b)
+NEON_QREG_3OP(max_u8, 8, uint8_t, _mm_max_epu8(a, b), a > b ? a : b)
+NEON_QREG_3OP(max_s16, 16, int16_t, _mm_max_epi16(a, b), a > b ? a : b)
+NEON_QREG_3OP(max_u16, 16, uint16_t,
+              neon_qreg_sel(neon_qreg_cgt_u16(a, b), a, b), a > b ? a : b)
+NEON_QREG_3OP(max_s32, 32, int32_t,
+              neon_qreg_sel(_mm_cmpgt_epi32(a, b), a, b), a > b ? a : b)
+NEON_QREG_3OP(max_u32, 32, uint32_t,
+              neon_qreg_sel(neon_qreg_cgt_u32(a, b), a, b), a > b ? a : b)
+NEON_QREG_3OP(min_s8, 8, int8_t,
+              neon_qreg_sel(_mm_cmpgt_epi8(a, b), b, a), a < b ? a : b)
+NEON_QREG_3OP(min_u8, 8, uint8_t, _mm_min_epu8(a, b), a < b ? a : b)
+NEON_QREG_3OP(min_s16, 16, int16_t, _mm_min_epi16(a, b), a < b ? a : b)
+NEON_QREG_3OP(min_u16, 16, uint16_t,
+              neon_qreg_sel(neon_qreg_cgt_u16(a, b), b, a), a < b ? a : b)
+NEON_QREG_3OP(min_s32, 32, int32_t,
+              neon_qreg_sel(_mm_cmpgt_epi32(a, b), b, a), a < b ? a : b)
+NEON_QREG_3OP(min_u32, 32, uint32_t,
+              neon_qreg_sel(neon_qreg_cgt_u32(a, b), b, a), a < b ? a : b)
+
+/* Shift by immediate, as used by VSHL and VSHR.  Shift counts of the
+   element size or more give zero (or all sign bits), as on the guest.  */
+NEON_QREG_SHIFT(shl_u16, 16, uint16_t, _mm_sll_epi16(a, n),
+                shift >= 16 ? 0 : a << shift)
+NEON_QREG_SHIFT(shl_u32, 32, uint32_t, _mm_sll_epi32(a, n),
+                shift >= 32 ? 0 : a << shift)
+NEON_QREG_SHIFT(shl_u64, 64, uint64_t, _mm_sll_epi64(a, n),
+                shift >= 64 ? 0 : a << shift)
+NEON_QREG_SHIFT(shr_u16, 16, uint16_t, _mm_srl_epi16(a, n),
+                shift >= 16 ? 0 : a >> shift)
+NEON_QREG_SHIFT(shr_u32, 32, uint32_t, _mm_srl_epi32(a, n),
+                shift >= 32 ? 0 : a >> shift)
+NEON_QREG_SHIFT(shr_u64, 64, uint64_t, _mm_srl_epi64(a, n),
+                shift >= 64 ? 0 : a >> shift)
+NEON_QREG_SHIFT(shr_s16, 16, int16_t, _mm_sra_epi16(a, n),
+                a >> (shift >= 16 ? 15 : shift))
+NEON_QREG_SHIFT(shr_s32, 32, int32_t, _mm_sra_epi32(a, n),
+                a >> (shift >= 32 ? 31 : shift))
+
+NEON_QREG_ABS(abs_s8, 8, int8_t, _mm_abs_epi8)
+NEON_QREG_ABS(abs_s16, 16, int16_t, _mm_abs_epi16)
+NEON_QREG_ABS(abs_s32, 32, int32_t, _mm_abs_epi32)
@@ -19,6 +19,8 @@
 #include "cpu.h"
 #include "helper.h"
 #include "fault-injection-controller.h"
+#include "profiler.h"
+#include "fault-injection-campaign.h"
 
 #define SIGNBIT (uint32_t)0x80000000
 #define SIGNBIT64 ((uint64_t)1 << 63)
@@ -32,6 +34,8 @@ static void raise_exception(CPUARMState *env, int tt)
 void HELPER(fault_controller_call_time)(CPUARMState *env, uint32_t pc)
 {
     uint64_t pc64 = pc;
+    profile_insn_count++;
+    fies_campaign_check_limit(profile_insn_count);
     fault_injection_controller_init(env, (&pc64), NULL, FI_TIME, -1);
     pc = pc64;
 }
@@ -83,6 +87,36 @@ uint32_t HELPER(fault_controller_call_load_reg)(CPUARMState *env, uint32_t reg_v
 	return reg_val;
 }
 
+/*
+ * The same hooks for TBs translated while no fault can access the CPU
+ * registers.  They are declared TCG_CALL_NO_RWG, so the guest registers
+ * stay in host registers across the calls.
+ */
+void HELPER(fault_controller_call_time_nrwg)(CPUARMState *env, uint32_t pc)
+{
+    HELPER(fault_controller_call_time)(env, pc);
+}
+
+uint32_t HELPER(fault_controller_call_reg_decoder_nrwg)(CPUARMState *env, uint32_t regno)
+{
+    return HELPER(fault_controller_call_reg_decoder)(env, regno);
+}
+
+uint32_t HELPER(fault_controller_call_store_reg_nrwg)(CPUARMState *env, uint32_t value_to_write, uint32_t regno)
+{
+    return HELPER(fault_controller_call_store_reg)(env, value_to_write, regno);
+}
+
+uint32_t HELPER(fault_controller_call_load_reg_nrwg)(CPUARMState *env, uint32_t reg_val, uint32_t regno)
+{
+    return HELPER(fault_controller_call_load_reg)(env, reg_val, regno);
+}
+
+void *HELPER(lookup_tb_ptr)(CPUARMState *env)
+{
+    return tb_lookup_tc_ptr(env);
+}
+
 uint32_t HELPER(neon_tbl)(CPUARMState *env, uint32_t ireg, uint32_t def,
                           uint32_t rn, uint32_t maxindex)
 {
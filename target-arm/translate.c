@@ -80,6 +80,9 @@ static TCGv_i32 cpu_exclusive_info;
 static TCGv_i32 cpu_F0s, cpu_F1s;
 static TCGv_i64 cpu_F0d, cpu_F1d;
 
+/* NEON_HOST_* bits saying which whole Q register helpers are fast.  */
+static int neon_host_simd;
+
 #include "exec/gen-icount.h"
 
 static const char *regnames[] =
@@ -116,6 +119,8 @@ void arm_translate_init(void)
         offsetof(CPUARMState, exclusive_info), "exclusive_info");
 #endif
 
+    neon_host_simd = neon_host_simd_features();
+
     a64_translate_init();
 }
 
@@ -156,14 +161,31 @@ static void load_reg_var(DisasContext *s, TCGv_i32 var, int reg)
 /* Create a new temporary and set it to the value of a CPU register.  */
 static inline TCGv_i32 load_reg(DisasContext *s, int reg)
 {
-	TCGv_i32 tcg_reg = tcg_const_i32(reg);
+    TCGv_i32 tcg_reg;
     TCGv_i32 tmp = tcg_temp_new_i32();
 
-	gen_helper_fault_controller_call_reg_decoder(tcg_reg, cpu_env, tcg_reg);
+    s->regs_accessed |= 1 << reg;
+    if (!(s->reg_hooks & (1 << reg))) {
+        load_reg_var(s, tmp, reg);
+        return tmp;
+    }
+
+    tcg_reg = tcg_const_i32(reg);
+    if (s->fies_regs) {
+        gen_helper_fault_controller_call_reg_decoder(tcg_reg, cpu_env, tcg_reg);
+    } else {
+        gen_helper_fault_controller_call_reg_decoder_nrwg(tcg_reg, cpu_env,
+                                                          tcg_reg);
+    }
     load_reg_var(s, tmp, reg);
 
     //read
-    gen_helper_fault_controller_call_load_reg(tmp, cpu_env, tmp, tcg_reg);
+    if (s->fies_regs) {
+        gen_helper_fault_controller_call_load_reg(tmp, cpu_env, tmp, tcg_reg);
+    } else {
+        gen_helper_fault_controller_call_load_reg_nrwg(tmp, cpu_env, tmp,
+                                                       tcg_reg);
+    }
     tcg_temp_free_i32(tcg_reg);
 
     return tmp;
@@ -173,11 +195,25 @@ static inline TCGv_i32 load_reg(DisasContext *s, int reg)
    marked as dead.  */
 static void store_reg(DisasContext *s, int reg, TCGv_i32 var)
 {
-	TCGv_i32 tcg_reg = tcg_const_i32(reg);
-
-    //write
-	gen_helper_fault_controller_call_reg_decoder(tcg_reg, cpu_env, tcg_reg);
-    gen_helper_fault_controller_call_store_reg(var, cpu_env, var, tcg_reg);
+    TCGv_i32 tcg_reg;
+
+    s->regs_accessed |= 1 << reg;
+    if (s->reg_hooks & (1 << reg)) {
+        tcg_reg = tcg_const_i32(reg);
+        //write
+        if (s->fies_regs) {
+            gen_helper_fault_controller_call_reg_decoder(tcg_reg, cpu_env,
+                                                         tcg_reg);
+            gen_helper_fault_controller_call_store_reg(var, cpu_env, var,
+                                                       tcg_reg);
+        } else {
+            gen_helper_fault_controller_call_reg_decoder_nrwg(tcg_reg, cpu_env,
+                                                              tcg_reg);
+            gen_helper_fault_controller_call_store_reg_nrwg(var, cpu_env, var,
+                                                            tcg_reg);
+        }
+        tcg_temp_free_i32(tcg_reg);
+    }
 
     if (reg == 15) {
         tcg_gen_andi_i32(var, var, ~1);
@@ -185,8 +221,6 @@ static void store_reg(DisasContext *s, int reg, TCGv_i32 var)
     }
 
     tcg_gen_mov_i32(cpu_R[reg], var);
-
-    tcg_temp_free_i32(tcg_reg);
     tcg_temp_free_i32(var);
 }
 
@@ -803,10 +837,12 @@ static inline void gen_bx_im(DisasContext *s, uint32_t addr)
     tcg_gen_movi_i32(cpu_R[15], addr & ~1);
 }
 
-/* Set PC and Thumb state from var.  var is marked as dead.  */
+/* Set PC and Thumb state from var.  var is marked as dead.  Only the PC
+   and the Thumb bit change, so the next TB can be looked up directly from
+   the generated code (see gen_goto_ptr).  */
 static inline void gen_bx(DisasContext *s, TCGv_i32 var)
 {
-    s->is_jmp = DISAS_UPDATE;
+    s->is_jmp = DISAS_JUMP;
     tcg_gen_andi_i32(cpu_R[15], var, ~1);
     tcg_gen_andi_i32(var, var, 1);
     store_cpu_field(var, thumb);
@@ -3440,6 +3476,7 @@ static inline void gen_goto_tb(DisasContext *s, int n, target_ulong dest)
     TranslationBlock *tb;
 
     tb = s->tb;
+    tb->succ_pc[n] = dest;
     if ((tb->pc & TARGET_PAGE_MASK) == (dest & TARGET_PAGE_MASK)) {
         tcg_gen_goto_tb(n);
         gen_set_pc_im(s, dest);
@@ -3450,6 +3487,16 @@ static inline void gen_goto_tb(DisasContext *s, int n, target_ulong dest)
     }
 }
 
+/* Jump to the TB matching the CPU state in env, e.g. after an indirect
+   branch.  Falls back to the main loop if the TB is not in the jump cache.  */
+static inline void gen_goto_ptr(void)
+{
+    TCGv_ptr ptr = tcg_temp_new_ptr();
+    gen_helper_lookup_tb_ptr(ptr, cpu_env);
+    tcg_gen_goto_ptr(ptr);
+    tcg_temp_free_ptr(ptr);
+}
+
 static inline void gen_jmp (DisasContext *s, uint32_t dest)
 {
     if (unlikely(s->singlestep_enabled)) {
@@ -4524,6 +4571,148 @@ static const uint8_t neon_2rm_sizes[] = {
     [NEON_2RM_VCVT_UF] = 0x4,
 };
 
+typedef void NeonGenQregFn(TCGv_ptr, TCGv_i32, TCGv_i32, TCGv_i32);
+
+/* Whole Q register helpers for three-register-same ops, indexed by op
+   and then (size << 1) | u like GEN_NEON_INTEGER_OP.  */
+static NeonGenQregFn * const neon_3r_qreg_fns[32][6] = {
+    [NEON_3R_VQADD] = {
+        gen_helper_neon_qreg_qadd_s8, gen_helper_neon_qreg_qadd_u8,
+        gen_helper_neon_qreg_qadd_s16, gen_helper_neon_qreg_qadd_u16,
+    },
+    [NEON_3R_VQSUB] = {
+        gen_helper_neon_qreg_qsub_s8, gen_helper_neon_qreg_qsub_u8,
+        gen_helper_neon_qreg_qsub_s16, gen_helper_neon_qreg_qsub_u16,
+    },
+    [NEON_3R_VCGT] = {
+        gen_helper_neon_qreg_cgt_s8, gen_helper_neon_qreg_cgt_u8,
+        gen_helper_neon_qreg_cgt_s16, gen_helper_neon_qreg_cgt_u16,
+        gen_helper_neon_qreg_cgt_s32, gen_helper_neon_qreg_cgt_u32,
+    },
+    [NEON_3R_VCGE] = {
+        gen_helper_neon_qreg_cge_s8, gen_helper_neon_qreg_cge_u8,
+        gen_helper_neon_qreg_cge_s16, gen_helper_neon_qreg_cge_u16,
+        gen_helper_neon_qreg_cge_s32, gen_helper_neon_qreg_cge_u32,
+    },
+    [NEON_3R_VMAX] = {
+        gen_helper_neon_qreg_max_s8, gen_helper_neon_qreg_max_u8,
+        gen_helper_neon_qreg_max_s16, gen_helper_neon_qreg_max_u16,
+        gen_helper_neon_qreg_max_s32, gen_helper_neon_qreg_max_u32,
+    },
+    [NEON_3R_VMIN] = {
+        gen_helper_neon_qreg_min_s8, gen_helper_neon_qreg_min_u8,
+        gen_helper_neon_qreg_min_s16, gen_helper_neon_qreg_min_u16,
+        gen_helper_neon_qreg_min_s32, gen_helper_neon_qreg_min_u32,
+    },
+    [NEON_3R_VADD_VSUB] = {
+        gen_helper_neon_qreg_add_u8, gen_helper_neon_qreg_sub_u8,
+        gen_helper_neon_qreg_add_u16, gen_helper_neon_qreg_sub_u16,
+        gen_helper_neon_qreg_add_u32, gen_helper_neon_qreg_sub_u32,
+    },
+    [NEON_3R_VTST_VCEQ] = {
+        gen_helper_neon_qreg_tst_u8, gen_helper_neon_qreg_ceq_u8,
+        gen_helper_neon_qreg_tst_u16, gen_helper_neon_qreg_ceq_u16,
+        gen_helper_neon_qreg_tst_u32, gen_helper_neon_qreg_ceq_u32,
+    },
+    [NEON_3R_VMUL] = { /* no polynomial (U=1) version */
+        gen_helper_neon_qreg_mul_u8, NULL,
+        gen_helper_neon_qreg_mul_u16, NULL,
+        gen_helper_neon_qreg_mul_u32, NULL,
+    },
+};
+
+/* Emit a single helper call for a whole Q register three-register-same
+   op.  Return nonzero if there is no such helper, in which case the
+   caller falls back to operating on 32-bit chunks.  */
+static int gen_neon_3r_qreg(int op, int size, int u, int rd, int rn, int rm)
+{
+    NeonGenQregFn *fn;
+    TCGv_i32 tmp, tmp2, tmp3;
+
+    if (!(neon_host_simd & NEON_HOST_SSE2) || size > 2) {
+        return 1;
+    }
+    fn = neon_3r_qreg_fns[op][(size << 1) | u];
+    if (!fn) {
+        return 1;
+    }
+    tmp = tcg_const_i32(rd);
+    tmp2 = tcg_const_i32(rn);
+    tmp3 = tcg_const_i32(rm);
+    fn(cpu_env, tmp, tmp2, tmp3);
+    tcg_temp_free_i32(tmp);
+    tcg_temp_free_i32(tmp2);
+    tcg_temp_free_i32(tmp3);
+    return 0;
+}
+
+/* Likewise for VSHR and VSHL by immediate; SHIFT is negative for right
+   shifts.  There are no byte or signed 64-bit versions.  */
+static int gen_neon_shift_qreg(int op, int size, int u, int rd, int rm,
+                               int shift)
+{
+    NeonGenQregFn *fn = NULL;
+    TCGv_i32 tmp, tmp2, tmp3;
+
+    if (!(neon_host_simd & NEON_HOST_SSE2)) {
+        return 1;
+    }
+    if (op == 0) { /* VSHR */
+        switch ((size << 1) | u) {
+        case 2: fn = gen_helper_neon_qreg_shr_s16; break;
+        case 3: fn = gen_helper_neon_qreg_shr_u16; break;
+        case 4: fn = gen_helper_neon_qreg_shr_s32; break;
+        case 5: fn = gen_helper_neon_qreg_shr_u32; break;
+        case 7: fn = gen_helper_neon_qreg_shr_u64; break;
+        }
+        shift = -shift;
+    } else if (op == 5 && !u) { /* VSHL */
+        switch (size) {
+        case 1: fn = gen_helper_neon_qreg_shl_u16; break;
+        case 2: fn = gen_helper_neon_qreg_shl_u32; break;
+        case 3: fn = gen_helper_neon_qreg_shl_u64; break;
+        }
+    }
+    if (!fn) {
+        return 1;
+    }
+    tmp = tcg_const_i32(rd);
+    tmp2 = tcg_const_i32(rm);
+    tmp3 = tcg_const_i32(shift);
+    fn(cpu_env, tmp, tmp2, tmp3);
+    tcg_temp_free_i32(tmp);
+    tcg_temp_free_i32(tmp2);
+    tcg_temp_free_i32(tmp3);
+    return 0;
+}
+
+static int gen_neon_abs_qreg(int size, int rd, int rm)
+{
+    TCGv_i32 tmp, tmp2;
+
+    if (!(neon_host_simd & NEON_HOST_SSSE3)) {
+        return 1;
+    }
+    tmp = tcg_const_i32(rd);
+    tmp2 = tcg_const_i32(rm);
+    switch (size) {
+    case 0:
+        gen_helper_neon_qreg_abs_s8(cpu_env, tmp, tmp2);
+        break;
+    case 1:
+        gen_helper_neon_qreg_abs_s16(cpu_env, tmp, tmp2);
+        break;
+    case 2:
+        gen_helper_neon_qreg_abs_s32(cpu_env, tmp, tmp2);
+        break;
+    default:
+        abort();
+    }
+    tcg_temp_free_i32(tmp);
+    tcg_temp_free_i32(tmp2);
+    return 0;
+}
+
 /* Translate a NEON data processing instruction.  Return nonzero if the
    instruction is invalid.
    We process data in a mixture of 32-bit and 64-bit chunks.
@@ -4700,6 +4889,10 @@ static int disas_neon_data_insn(CPUARMState * env, DisasContext *s, uint32_t ins
             return 1;
         }
 
+        if (q && !gen_neon_3r_qreg(op, size, u, rd, rn, rm)) {
+            return 0;
+        }
+
         for (pass = 0; pass < (q ? 4 : 2); pass++) {
 
         if (pairwise) {
@@ -5038,6 +5231,9 @@ static int disas_neon_data_insn(CPUARMState * env, DisasContext *s, uint32_t ins
                    element size in bits.  */
                 if (op <= 4)
                     shift = shift - (1 << (size + 3));
+                if (q && !gen_neon_shift_qreg(op, size, u, rd, rm, shift)) {
+                    return 0;
+                }
                 if (size == 3) {
                     count = q + 1;
                 } else {
@@ -6005,6 +6201,11 @@ static int disas_neon_data_insn(CPUARMState * env, DisasContext *s, uint32_t ins
                     tcg_temp_free_i32(tmp2);
                     tcg_temp_free_i32(tmp3);
                     break;
+                case NEON_2RM_VABS:
+                    if (q && !gen_neon_abs_qreg(size, rd, rm)) {
+                        break;
+                    }
+                    goto elementwise;
                 default:
                 elementwise:
                     for (pass = 0; pass < (q ? 4 : 2); pass++) {
@@ -10014,6 +10215,224 @@ undef:
     gen_exception_insn(s, 2, EXCP_UDEF);
 }
 
+/* Condition flag liveness for ARM mode TBs.
+ *
+ * Most flag setting instructions are followed by another one before the
+ * flags are tested.  Before translation the instructions of the TB are
+ * scanned, and a flag that an instruction sets but that no later
+ * instruction (or the end of the TB) reads is computed into a temporary
+ * instead of the CPU state.  TCG then drops the computation, and the
+ * global is neither written nor synced at the FIES helper calls.
+ *
+ * Only unconditional data processing and multiply instructions are
+ * analysed.  Everything else may read the flags, raise an exception or
+ * start a new basic block (which would lose the temporaries), so it is
+ * treated as reading all flags.
+ */
+#define CC_N    (1 << 0)
+#define CC_Z    (1 << 1)
+#define CC_C    (1 << 2)
+#define CC_V    (1 << 3)
+#define CC_ALL  (CC_N | CC_Z | CC_C | CC_V)
+
+#define CC_MAX_INSNS  (TARGET_PAGE_SIZE / 4)
+
+static TCGv_i32 *const cc_var[4] = { &cpu_NF, &cpu_ZF, &cpu_CF, &cpu_VF };
+static TCGv_i32 cc_global[4], cc_tmp[4];
+
+/* Flags read and set by an ARM mode instruction.  Returns false, with
+   all flags read, for instructions that are not analysed.  */
+static bool arm_insn_cc(uint32_t insn, int *use, int *set)
+{
+    int op, shift_c;
+
+    *use = CC_ALL;
+    *set = 0;
+    if ((insn >> 28) != 0xe) {
+        return false;
+    }
+    if ((insn & 0x0fc000f0) == 0x00000090) {
+        /* mul, mla */
+        if (((insn >> 16) & 0xf) == 15) {
+            return false;
+        }
+        *use = 0;
+        *set = (insn & (1 << 20)) ? CC_N | CC_Z : 0;
+        return true;
+    }
+    if ((insn & 0x0f8000f0) == 0x00800090) {
+        /* umull, umlal, smull, smlal */
+        if (((insn >> 16) & 0xf) == 15 || ((insn >> 12) & 0xf) == 15) {
+            return false;
+        }
+        *use = 0;
+        *set = (insn & (1 << 20)) ? CC_N | CC_Z : 0;
+        return true;
+    }
+    if ((insn & 0x0c000000) != 0 || (insn & 0x02000090) == 0x90) {
+        return false;
+    }
+
+    /* data processing */
+    op = (insn >> 21) & 0xf;
+    if (op >= 8 && op <= 11) {
+        if (!(insn & (1 << 20))) {
+            /* miscellaneous instructions, msr, movw, movt */
+            return false;
+        }
+    } else if (((insn >> 12) & 0xf) == 15) {
+        return false;
+    }
+    *use = 0;
+    if (op >= 5 && op <= 7) {
+        /* adc, sbc, rsc */
+        *use |= CC_C;
+    }
+    if (insn & (1 << 25)) {
+        shift_c = ((insn >> 8) & 0xf) != 0;
+    } else if (insn & (1 << 4)) {
+        /* The shift helpers keep C for a zero shift count.  */
+        if (table_logic_cc[op] && (insn & (1 << 20))) {
+            *use |= CC_C;
+        }
+        shift_c = 1;
+    } else {
+        if (((insn >> 5) & 3) == 3 && ((insn >> 7) & 0x1f) == 0) {
+            /* rrx */
+            *use |= CC_C;
+        }
+        shift_c = (insn & 0xfe0) != 0;
+    }
+    if (insn & (1 << 20)) {
+        if (table_logic_cc[op]) {
+            *set = CC_N | CC_Z | (shift_c ? CC_C : 0);
+        } else {
+            *set = CC_ALL;
+        }
+    }
+    return true;
+}
+
+/* Fill s->cc_info with the dead (low nibble) and set (high nibble) flags
+   of the instructions from s->pc to the end of the page or max_insns.  */
+static void arm_cc_liveness(CPUARMState *env, DisasContext *s,
+                            target_ulong next_page_start, int max_insns)
+{
+    int use[CC_MAX_INSNS], set[CC_MAX_INSNS];
+    target_ulong pc = s->pc;
+    bool known = true;
+    int n, live;
+
+    for (n = 0; known && n < max_insns && n < CC_MAX_INSNS &&
+         pc < next_page_start; n++, pc += 4) {
+        known = arm_insn_cc(arm_ldl_code(env, pc, s->bswap_code),
+                            &use[n], &set[n]);
+    }
+
+    live = CC_ALL;
+    while (n-- > 0) {
+        s->cc_info[n] = (set[n] & ~use[n] & ~live) | (set[n] << 4);
+        live = (live & ~set[n]) | use[n];
+    }
+}
+
+/* Point the flag globals of the dead flags of the next instruction to
+   temporaries, and back to the CPU state for flags that it sets live.  */
+static void gen_cc_redirect(DisasContext *s, int info)
+{
+    int dead = info & CC_ALL;
+    int set = info >> 4;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        if (s->cc_temp & (1 << i)) {
+            if ((set & (1 << i)) && !(dead & (1 << i))) {
+                *cc_var[i] = cc_global[i];
+                s->cc_temp &= ~(1 << i);
+            }
+        } else if (dead & (1 << i)) {
+            *cc_var[i] = cc_tmp[i];
+            s->cc_temp |= 1 << i;
+        }
+    }
+}
+
+/* Copy flags still held in temporaries back to the CPU state.  Only
+   needed when the TB ends before the instruction that sets them again.  */
+static void gen_cc_flush(DisasContext *s)
+{
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        if (s->cc_temp & (1 << i)) {
+            tcg_gen_mov_i32(cc_global[i], cc_tmp[i]);
+            *cc_var[i] = cc_global[i];
+        }
+    }
+    s->cc_temp = 0;
+}
+
+/* Maximum number of conditional branches followed by a superblock.  */
+#define SB_MAX_BRANCHES 8
+
+/* Leave a superblock through a side exit to dest.  The two goto_tb
+   slots belong to the end of the superblock, so side exits go through
+   the jump cache.  */
+static void gen_sb_exit(DisasContext *s, uint32_t dest)
+{
+    gen_set_pc_im(s, dest);
+    if (TCG_TARGET_HAS_goto_ptr) {
+        gen_goto_ptr();
+    } else {
+        tcg_gen_exit_tb(0);
+    }
+}
+
+/* In a superblock (CF_SUPERBLOCK), translate a conditional B at s->pc
+   whose target is on the same page as a side exit, and continue with
+   the expected successor.  The first branch follows the profile of the
+   TB (CF_SB_TAKEN); later branches are predicted taken if they point
+   backwards.  Returns false if the insn is not such a branch.  */
+static bool gen_sb_branch(CPUARMState *env, DisasContext *s,
+                          target_ulong pc_start, target_ulong next_page_start)
+{
+    uint32_t insn, cond, dest;
+    bool taken;
+    int label;
+
+    insn = arm_ldl_code(env, s->pc, s->bswap_code);
+    cond = insn >> 28;
+    if ((insn & 0x0f000000) != 0x0a000000 || cond >= 0xe) {
+        return false;
+    }
+    dest = s->pc + 8 + (sextract32(insn, 0, 24) << 2);
+    if (dest < pc_start || dest >= next_page_start) {
+        return false;
+    }
+    if (s->sb_branches == SB_MAX_BRANCHES) {
+        taken = (s->tb->cflags & CF_SB_TAKEN) != 0;
+    } else {
+        taken = dest <= s->pc;
+    }
+
+    /* The side exit needs the flags in the CPU state.  */
+    gen_cc_flush(s);
+    label = gen_new_label();
+    if (taken) {
+        gen_test_cc(cond, label);
+        gen_sb_exit(s, s->pc + 4);
+    } else {
+        gen_test_cc(cond ^ 1, label);
+        gen_sb_exit(s, dest);
+    }
+    gen_set_label(label);
+
+    s->sb_end = MAX(s->sb_end, s->pc + 4);
+    s->pc = taken ? dest : s->pc + 4;
+    s->sb_branches--;
+    return true;
+}
+
 /* generate intermediate code in gen_opc_buf and gen_opparam_buf for
    basic block 'tb'. If search_pc is TRUE, also generate PC
    information for each intermediate instruction. */
@@ -10026,12 +10445,14 @@ static inline void gen_intermediate_code_internal(ARMCPU *cpu,
     DisasContext dc1, *dc = &dc1;
     CPUBreakpoint *bp;
     TCGv_i32 tcg_pc;
+    bool sb_branch;
     uint16_t *gen_opc_end;
     int j, lj;
     target_ulong pc_start;
     target_ulong next_page_start;
     int num_insns;
     int max_insns;
+    uint8_t cc_info[CC_MAX_INSNS];
 
     /* generate intermediate code */
     pc_start = tb->pc;
@@ -10085,6 +10506,43 @@ static inline void gen_intermediate_code_internal(ARMCPU *cpu,
     if (max_insns == 0)
         max_insns = CF_COUNT_MASK;
 
+    /* Unless a loaded fault can access the CPU registers, the fault
+       injection hooks neither read nor write the TCG globals, and the
+       guest registers can stay in host registers across them.  */
+    dc->fies_regs = fault_injection_controller_regs_observed();
+    tcg_ctx.globals_in_saved_regs = !dc->fies_regs;
+
+    /* The register hooks are only called for the registers that a loaded
+       fault can act on.  The TB remembers which registers it accesses,
+       so that it is invalidated when the hooked registers change.  */
+    dc->reg_hooks = fault_injection_controller_reg_hooks();
+    dc->regs_accessed = 0;
+
+    /* Flags can only be left in temporaries if no fault injection hook
+       reads them and the TB is not cut short by the debugger.  */
+    memset(cc_info, 0, sizeof(cc_info));
+    dc->cc_info = cc_info;
+    dc->cc_temp = 0;
+    if (!dc->aarch64 && !dc->thumb && !dc->singlestep_enabled && !singlestep
+        && QTAILQ_EMPTY(&env->breakpoints)
+        && !fault_injection_controller_flags_observed()) {
+        arm_cc_liveness(env, dc, next_page_start, max_insns);
+        for (j = 0; j < 4; j++) {
+            cc_global[j] = *cc_var[j];
+            cc_tmp[j] = tcg_temp_new_i32();
+        }
+    }
+
+    /* The decoder fault hooks see every instruction, so superblocks are
+       only formed while no CPU or register fault is loaded.  */
+    dc->sb_branches = 0;
+    dc->sb_end = pc_start;
+    if ((tb->cflags & CF_SUPERBLOCK) && !dc->aarch64 && !dc->thumb
+        && !dc->fies_regs && !dc->singlestep_enabled && !singlestep
+        && QTAILQ_EMPTY(&env->breakpoints)) {
+        dc->sb_branches = SB_MAX_BRANCHES;
+    }
+
     gen_tb_start();
 
     tcg_clear_temp_count();
@@ -10179,6 +10637,7 @@ static inline void gen_intermediate_code_internal(ARMCPU *cpu,
             tcg_gen_debug_insn_start(dc->pc);
         }
 
+        sb_branch = false;
         if (dc->aarch64) {
             disas_a64_insn(env, dc);
         } else if (dc->thumb) {
@@ -10191,7 +10650,13 @@ static inline void gen_intermediate_code_internal(ARMCPU *cpu,
                     dc->condexec_cond = 0;
                 }
             }
+        } else if (dc->sb_branches &&
+                   gen_sb_branch(env, dc, pc_start, next_page_start)) {
+            sb_branch = true;
         } else {
+            if (num_insns < CC_MAX_INSNS) {
+                gen_cc_redirect(dc, dc->cc_info[num_insns]);
+            }
             disas_arm_insn(env, dc);
         }
 
@@ -10210,9 +10675,18 @@ static inline void gen_intermediate_code_internal(ARMCPU *cpu,
          * Also stop translation when a page boundary is reached.  This
          * ensures prefetch aborts occur at the right place.  */
         num_insns ++;
+        dc->sb_end = MAX(dc->sb_end, dc->pc);
+        if (sb_branch) {
+            /* A branch ends a TB before the time hook is reached */
+            continue;
+        }
 
         tcg_pc = tcg_const_i32(dc->pc);
-        gen_helper_fault_controller_call_time(cpu_env, tcg_pc);
+        if (dc->fies_regs) {
+            gen_helper_fault_controller_call_time(cpu_env, tcg_pc);
+        } else {
+            gen_helper_fault_controller_call_time_nrwg(cpu_env, tcg_pc);
+        }
         tcg_temp_free_i32(tcg_pc);
     } while (!dc->is_jmp && tcg_ctx.gen_opc_ptr < gen_opc_end &&
              !cs->singlestep_enabled &&
@@ -10220,6 +10694,8 @@ static inline void gen_intermediate_code_internal(ARMCPU *cpu,
              dc->pc < next_page_start &&
              num_insns < max_insns);
 
+    gen_cc_flush(dc);
+
     if (tb->cflags & CF_LAST_IO) {
         if (dc->condjmp) {
             /* FIXME:  This can theoretically happen with self-modifying
@@ -10269,8 +10745,15 @@ static inline void gen_intermediate_code_internal(ARMCPU *cpu,
         case DISAS_NEXT:
             gen_goto_tb(dc, 1, dc->pc);
             break;
-        default:
         case DISAS_JUMP:
+            /* only the PC (and Thumb bit) changed: chain to the next TB
+               without going back to the main loop if it is cached */
+            if (TCG_TARGET_HAS_goto_ptr) {
+                gen_goto_ptr();
+                break;
+            }
+            /* fall through */
+        default:
         case DISAS_UPDATE:
             /* indicate that the hash table must be used to find the next TB */
             tcg_gen_exit_tb(0);
@@ -10302,7 +10785,7 @@ done_generating:
     if (qemu_loglevel_mask(CPU_LOG_TB_IN_ASM)) {
         qemu_log("----------------\n");
         qemu_log("IN: %s\n", lookup_symbol(pc_start));
-        log_target_disas(env, pc_start, dc->pc - pc_start,
+        log_target_disas(env, pc_start, dc->sb_end - pc_start,
                          dc->thumb | (dc->bswap_code << 1));
         qemu_log("\n");
     }
@@ -10313,8 +10796,9 @@ done_generating:
         while (lj <= j)
             tcg_ctx.gen_opc_instr_start[lj++] = 0;
     } else {
-        tb->size = dc->pc - pc_start;
+        tb->size = dc->sb_end - pc_start;
         tb->icount = num_insns;
+        tb->regs_accessed = dc->regs_accessed;
     }
 }
 
@@ -24,6 +24,20 @@ typedef struct DisasContext {
     int vec_len;
     int vec_stride;
     int aarch64;
+    /* Per instruction dead and set condition flags (ARM mode).  */
+    uint8_t *cc_info;
+    /* Flags currently computed into temporaries.  */
+    int cc_temp;
+    /* Nonzero if the FIES hooks may access the CPU registers.  */
+    int fies_regs;
+    /* Registers whose loads and stores call the FIES register hooks,
+       and registers loaded or stored so far (bit n = register n).  */
+    uint32_t reg_hooks;
+    uint32_t regs_accessed;
+    /* Conditional branches a superblock may still follow.  */
+    int sb_branches;
+    /* End of the guest code translated so far.  */
+    target_ulong sb_end;
 } DisasContext;
 
 extern TCGv_ptr cpu_env;
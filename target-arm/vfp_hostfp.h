@@ -0,0 +1,105 @@
+/*
+ * Host FPU fast path for VFP single/double arithmetic.
+ *
+ * This code is licensed under the GPL.
+ */
+
+#ifndef VFP_HOSTFP_H
+#define VFP_HOSTFP_H
+
+#include <float.h>
+#include <math.h>
+#include "fpu/softfloat.h"
+
+/* The host FPU computes exactly the same IEEE 754 result and exception
+ * flags as softfloat as long as:
+ *  - the rounding mode is round-to-nearest-even (the host default);
+ *  - both operands are zero or normal, so NaN handling, default NaN mode
+ *    and input flushing cannot make a difference;
+ *  - the result is neither infinite nor tiny, so there is no overflow,
+ *    underflow or output flushing to account for;
+ *  - the inexact flag is already set, so we do not need to find out
+ *    whether this particular operation was exact.
+ * Everything else returns false and the caller falls back to softfloat.
+ * Scalar SSE2 arithmetic is required to avoid x87 excess precision.
+ */
+#if defined(__SSE2_MATH__)
+#define VFP_HOSTFP_ENABLED 1
+#else
+#define VFP_HOSTFP_ENABLED 0
+#endif
+
+static inline bool vfp_hostfp_usable(float_status *s)
+{
+    return VFP_HOSTFP_ENABLED &&
+           (s->float_exception_flags & float_flag_inexact) &&
+           s->float_rounding_mode == float_round_nearest_even;
+}
+
+static inline bool vfp_hostfp_zero_or_normals(float32 a)
+{
+    uint32_t exp = (float32_val(a) >> 23) & 0xff;
+    return exp != 0xff && (exp != 0 || float32_is_zero(a));
+}
+
+static inline bool vfp_hostfp_zero_or_normald(float64 a)
+{
+    uint64_t exp = (float64_val(a) >> 52) & 0x7ff;
+    return exp != 0x7ff && (exp != 0 || float64_is_zero(a));
+}
+
+/* A zero result is only known to be exact if both inputs were zero;
+   for anything else a tiny result may have underflowed.  */
+#define VFP_HOSTFP_BINOP(name, op, is_div)                                  \
+static inline bool vfp_hostfp_##name##s(float32 a, float32 b, float32 *r,   \
+                                        float_status *s)                    \
+{                                                                           \
+    union { uint32_t i; float f; } ua, ub, ur;                              \
+                                                                            \
+    if (!vfp_hostfp_usable(s) || !vfp_hostfp_zero_or_normals(a) ||          \
+        !vfp_hostfp_zero_or_normals(b) || (is_div && float32_is_zero(b))) { \
+        return false;                                                       \
+    }                                                                       \
+    ua.i = float32_val(a);                                                  \
+    ub.i = float32_val(b);                                                  \
+    ur.f = ua.f op ub.f;                                                    \
+    if (unlikely(isinf(ur.f))) {                                            \
+        return false;                                                       \
+    }                                                                       \
+    if (unlikely(fabsf(ur.f) <= FLT_MIN) &&                                 \
+        !(float32_is_zero(a) && float32_is_zero(b))) {                      \
+        return false;                                                       \
+    }                                                                       \
+    *r = make_float32(ur.i);                                                \
+    return true;                                                            \
+}                                                                           \
+static inline bool vfp_hostfp_##name##d(float64 a, float64 b, float64 *r,   \
+                                        float_status *s)                    \
+{                                                                           \
+    union { uint64_t i; double f; } ua, ub, ur;                             \
+                                                                            \
+    if (!vfp_hostfp_usable(s) || !vfp_hostfp_zero_or_normald(a) ||          \
+        !vfp_hostfp_zero_or_normald(b) || (is_div && float64_is_zero(b))) { \
+        return false;                                                       \
+    }                                                                       \
+    ua.i = float64_val(a);                                                  \
+    ub.i = float64_val(b);                                                  \
+    ur.f = ua.f op ub.f;                                                    \
+    if (unlikely(isinf(ur.f))) {                                            \
+        return false;                                                       \
+    }                                                                       \
+    if (unlikely(fabs(ur.f) <= DBL_MIN) &&                                  \
+        !(float64_is_zero(a) && float64_is_zero(b))) {                      \
+        return false;                                                       \
+    }                                                                       \
+    *r = make_float64(ur.i);                                                \
+    return true;                                                            \
+}
+
+VFP_HOSTFP_BINOP(add, +, 0)
+VFP_HOSTFP_BINOP(sub, -, 0)
+VFP_HOSTFP_BINOP(mul, *, 0)
+VFP_HOSTFP_BINOP(div, /, 1)
+#undef VFP_HOSTFP_BINOP
+
+#endif
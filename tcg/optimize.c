@@ -51,10 +51,33 @@ struct tcg_temp_info {
 
 static struct tcg_temp_info temps[TCG_MAX_TEMPS];
 
+/* An env field accessed in the current basic block.  LD is the load
+   opcode whose result is held in TEMP (INDEX_op_end if none), STORE the
+   index of a store to the field that nothing has read yet, or -1.  */
+struct tcg_mem_info {
+    tcg_target_long offset;
+    int size;
+    TCGOpcode ld;
+    TCGArg temp;
+    int store;
+};
+
+#define MAX_MEM_FIELDS 16
+
+static struct tcg_mem_info mems[MAX_MEM_FIELDS];
+static int nb_mems;
+
 /* Reset TEMP's state to TCG_TEMP_UNDEF.  If TEMP only had one copy, remove
    the copy flag from the left temp.  */
 static void reset_temp(TCGArg temp)
 {
+    int i;
+
+    for (i = 0; i < nb_mems; i++) {
+        if (mems[i].temp == temp) {
+            mems[i].ld = INDEX_op_end;
+        }
+    }
     if (temps[temp].state == TCG_TEMP_COPY) {
         if (temps[temp].prev_copy == temps[temp].next_copy) {
             temps[temps[temp].next_copy].state = TCG_TEMP_UNDEF;
@@ -75,6 +98,129 @@ static void reset_all_temps(int nb_temps)
         temps[i].state = TCG_TEMP_UNDEF;
         temps[i].mask = -1;
     }
+    nb_mems = 0;
+}
+
+/* Number of bytes accessed by a load or store opcode.  */
+static int mem_op_size(TCGOpcode op)
+{
+    switch (op) {
+    CASE_OP_32_64(ld8u):
+    CASE_OP_32_64(ld8s):
+    CASE_OP_32_64(st8):
+        return 1;
+    CASE_OP_32_64(ld16u):
+    CASE_OP_32_64(ld16s):
+    CASE_OP_32_64(st16):
+        return 2;
+    case INDEX_op_ld_i32:
+    case INDEX_op_ld32u_i64:
+    case INDEX_op_ld32s_i64:
+    case INDEX_op_st_i32:
+    case INDEX_op_st32_i64:
+        return 4;
+    default:
+        return 8;
+    }
+}
+
+/* Only accesses relative to the fixed env register are tracked; any other
+   base pointer may point into env.  */
+static bool mem_env_base(TCGContext *s, TCGArg base)
+{
+    return base < s->nb_globals && s->temps[base].fixed_reg;
+}
+
+static void mem_remove(int i)
+{
+    mems[i] = mems[--nb_mems];
+}
+
+static void mem_add(tcg_target_long offset, int size, TCGOpcode ld,
+                    TCGArg temp, int store)
+{
+    if (nb_mems < MAX_MEM_FIELDS) {
+        mems[nb_mems].offset = offset;
+        mems[nb_mems].size = size;
+        mems[nb_mems].ld = ld;
+        mems[nb_mems].temp = temp;
+        mems[nb_mems].store = store;
+        nb_mems++;
+    }
+}
+
+/* The field at OFFSET is read: stores to it are no longer dead.  */
+static void mem_read(tcg_target_long offset, int size)
+{
+    int i;
+
+    for (i = 0; i < nb_mems; i++) {
+        if (mems[i].offset < offset + size
+            && offset < mems[i].offset + mems[i].size) {
+            mems[i].store = -1;
+        }
+    }
+}
+
+/* Something outside the basic block may read every field.  */
+static void mem_read_all(void)
+{
+    int i;
+
+    for (i = 0; i < nb_mems; i++) {
+        mems[i].store = -1;
+    }
+}
+
+/* Find a temp that already holds the result of load OP from OFFSET.  */
+static bool mem_find(TCGOpcode op, tcg_target_long offset, TCGArg *temp)
+{
+    int i;
+
+    for (i = 0; i < nb_mems; i++) {
+        if (mems[i].ld == op && mems[i].offset == offset) {
+            *temp = mems[i].temp;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Record store OP at OP_INDEX.  Earlier stores that it completely
+   overwrites and that nothing has read are turned into nops.  */
+static void mem_store(TCGContext *s, TCGOpcode op, TCGArg *args,
+                      int op_index)
+{
+    tcg_target_long offset = args[2];
+    int size = mem_op_size(op);
+    TCGOpcode ld;
+    int i;
+
+    for (i = 0; i < nb_mems; ) {
+        if (mems[i].offset < offset + size
+            && offset < mems[i].offset + mems[i].size) {
+            if (mems[i].store >= 0 && offset <= mems[i].offset
+                && mems[i].offset + mems[i].size <= offset + size) {
+                s->gen_opc_buf[mems[i].store] = INDEX_op_nop3;
+            }
+            mem_remove(i);
+        } else {
+            i++;
+        }
+    }
+
+    switch (op) {
+    case INDEX_op_st_i32:
+        ld = INDEX_op_ld_i32;
+        break;
+    case INDEX_op_st_i64:
+        ld = INDEX_op_ld_i64;
+        break;
+    default:
+        ld = INDEX_op_end;
+        break;
+    }
+    mem_add(offset, size, ld, args[0], op_index);
 }
 
 static int op_bits(TCGOpcode op)
@@ -1108,8 +1254,66 @@ static TCGArg *tcg_constant_folding(TCGContext *s, uint16_t *tcg_opc_ptr,
             args += 6;
             break;
 
+        CASE_OP_32_64(ld8u):
+        CASE_OP_32_64(ld8s):
+        CASE_OP_32_64(ld16u):
+        CASE_OP_32_64(ld16s):
+        case INDEX_op_ld_i32:
+        case INDEX_op_ld32u_i64:
+        case INDEX_op_ld32s_i64:
+        case INDEX_op_ld_i64:
+            if (!mem_env_base(s, args[1])) {
+                mem_read_all();
+                goto do_default;
+            }
+            /* Forward the value stored to or loaded from the same env
+               field earlier in this basic block.  */
+            if (mem_find(op, args[2], &tmp)) {
+                if (temps_are_copies(args[0], tmp)) {
+                    s->gen_opc_buf[op_index] = INDEX_op_nop;
+                } else if (temps[tmp].state == TCG_TEMP_CONST) {
+                    s->gen_opc_buf[op_index] = op_to_movi(op);
+                    tcg_opt_gen_movi(gen_args, args[0], temps[tmp].val);
+                    gen_args += 2;
+                } else {
+                    s->gen_opc_buf[op_index] = op_to_mov(op);
+                    tcg_opt_gen_mov(s, gen_args, args[0], tmp);
+                    gen_args += 2;
+                }
+                args += 3;
+                break;
+            }
+            mem_read(args[2], mem_op_size(op));
+            reset_temp(args[0]);
+            mem_add(args[2], mem_op_size(op), op, args[0], -1);
+            gen_args[0] = args[0];
+            gen_args[1] = args[1];
+            gen_args[2] = args[2];
+            gen_args += 3;
+            args += 3;
+            break;
+
+        CASE_OP_32_64(st8):
+        CASE_OP_32_64(st16):
+        case INDEX_op_st_i32:
+        case INDEX_op_st32_i64:
+        case INDEX_op_st_i64:
+            if (!mem_env_base(s, args[1])) {
+                nb_mems = 0;
+            } else {
+                mem_store(s, op, args, op_index);
+            }
+            goto do_default;
+
         case INDEX_op_call:
             nb_call_args = (args[0] >> 16) + (args[0] & 0xffff);
+            /* Helpers may read and, unless they have no side effects,
+               write any env field.  */
+            if (args[nb_call_args + 1] & TCG_CALL_NO_SIDE_EFFECTS) {
+                mem_read_all();
+            } else {
+                nb_mems = 0;
+            }
             if (!(args[nb_call_args + 1] & (TCG_CALL_NO_READ_GLOBALS |
                                             TCG_CALL_NO_WRITE_GLOBALS))) {
                 for (i = 0; i < nb_globals; i++) {
@@ -1138,6 +1342,11 @@ static TCGArg *tcg_constant_folding(TCGContext *s, uint16_t *tcg_opc_ptr,
             if (def->flags & TCG_OPF_BB_END) {
                 reset_all_temps(nb_temps);
             } else {
+                /* Guest memory accesses may fault and leave the TB.  */
+                if (def->flags & (TCG_OPF_CALL_CLOBBER
+                                  | TCG_OPF_SIDE_EFFECTS)) {
+                    nb_mems = 0;
+                }
                 for (i = 0; i < def->nb_oargs; i++) {
                     reset_temp(args[i]);
                 }
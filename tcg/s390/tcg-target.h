@@ -100,6 +100,7 @@ typedef enum TCGReg {
 #define TCG_TARGET_HAS_mulsh_i64        0
 
 #define TCG_TARGET_HAS_new_ldst         0
+#define TCG_TARGET_HAS_goto_ptr         0
 
 extern bool tcg_target_deposit_valid(int ofs, int len);
 #define TCG_TARGET_deposit_i32_valid  tcg_target_deposit_valid
@@ -149,6 +149,7 @@ typedef enum {
 #endif
 
 #define TCG_TARGET_HAS_new_ldst         0
+#define TCG_TARGET_HAS_goto_ptr         0
 
 #define TCG_AREG0 TCG_REG_I0
 
@@ -1833,14 +1833,32 @@ static void tcg_reg_free(TCGContext *s, int reg)
     }
 }
 
-/* Allocate a register belonging to reg1 & ~reg2 */
-static int tcg_reg_alloc(TCGContext *s, TCGRegSet reg1, TCGRegSet reg2)
+/* Allocate a register belonging to reg1 & ~reg2 for TEMP, or for a
+   scratch value if TEMP is -1.  */
+static int tcg_reg_alloc(TCGContext *s, TCGRegSet reg1, TCGRegSet reg2,
+                         int temp)
 {
     int i, reg;
-    TCGRegSet reg_ct;
+    TCGRegSet reg_ct, pref;
 
     tcg_regset_andnot(reg_ct, reg1, reg2);
 
+    /* Keep globals in the registers that are preserved across helper
+       calls, so that they are not spilled at TCG_CALL_NO_RWG calls, and
+       other temporaries out of them.  */
+    if (s->globals_in_saved_regs && temp >= 0) {
+        if (temp < s->nb_globals) {
+            tcg_regset_andnot(pref, reg_ct, tcg_target_call_clobber_regs);
+        } else {
+            tcg_regset_and(pref, reg_ct, tcg_target_call_clobber_regs);
+        }
+        for(i = 0; i < ARRAY_SIZE(tcg_target_reg_alloc_order); i++) {
+            reg = tcg_target_reg_alloc_order[i];
+            if (tcg_regset_test_reg(pref, reg) && s->reg_to_temp[reg] == -1)
+                return reg;
+        }
+    }
+
     /* first try free registers */
     for(i = 0; i < ARRAY_SIZE(tcg_target_reg_alloc_order); i++) {
         reg = tcg_target_reg_alloc_order[i];
@@ -1889,7 +1907,7 @@ static inline void temp_sync(TCGContext *s, int temp, TCGRegSet allocated_regs)
         switch(ts->val_type) {
         case TEMP_VAL_CONST:
             ts->reg = tcg_reg_alloc(s, tcg_target_available_regs[ts->type],
-                                    allocated_regs);
+                                    allocated_regs, temp);
             ts->val_type = TEMP_VAL_REG;
             s->reg_to_temp[ts->reg] = temp;
             ts->mem_coherent = 0;
@@ -2026,7 +2044,7 @@ static void tcg_reg_alloc_mov(TCGContext *s, const TCGOpDef *def,
        we don't have to reload SOURCE the next time it is used. */
     if (((NEED_SYNC_ARG(0) || ots->fixed_reg) && ts->val_type != TEMP_VAL_REG)
         || ts->val_type == TEMP_VAL_MEM) {
-        ts->reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs);
+        ts->reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs, args[1]);
         if (ts->val_type == TEMP_VAL_MEM) {
             tcg_out_ld(s, ts->type, ts->reg, ts->mem_reg, ts->mem_offset);
             ts->mem_coherent = 1;
@@ -2074,7 +2092,8 @@ static void tcg_reg_alloc_mov(TCGContext *s, const TCGOpDef *def,
                 /* When allocating a new register, make sure to not spill the
                    input one. */
                 tcg_regset_set_reg(allocated_regs, ts->reg);
-                ots->reg = tcg_reg_alloc(s, oarg_ct->u.regs, allocated_regs);
+                ots->reg = tcg_reg_alloc(s, oarg_ct->u.regs, allocated_regs,
+                                         args[0]);
             }
             tcg_out_mov(s, ots->type, ots->reg, ts->reg);
         }
@@ -2116,7 +2135,7 @@ static void tcg_reg_alloc_op(TCGContext *s,
         arg_ct = &def->args_ct[i];
         ts = &s->temps[arg];
         if (ts->val_type == TEMP_VAL_MEM) {
-            reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs);
+            reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs, arg);
             tcg_out_ld(s, ts->type, reg, ts->mem_reg, ts->mem_offset);
             ts->val_type = TEMP_VAL_REG;
             ts->reg = reg;
@@ -2130,7 +2149,7 @@ static void tcg_reg_alloc_op(TCGContext *s,
                 goto iarg_end;
             } else {
                 /* need to move to a register */
-                reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs);
+                reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs, arg);
                 tcg_out_movi(s, ts->type, reg, ts->val);
                 ts->val_type = TEMP_VAL_REG;
                 ts->reg = reg;
@@ -2161,7 +2180,7 @@ static void tcg_reg_alloc_op(TCGContext *s,
         allocate_in_reg:
             /* allocate a new register matching the constraint 
                and move the temporary register into it */
-            reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs);
+            reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs, arg);
             tcg_out_mov(s, ts->type, reg, ts->reg);
         }
         new_args[i] = reg;
@@ -2210,7 +2229,7 @@ static void tcg_reg_alloc_op(TCGContext *s,
                     tcg_regset_test_reg(arg_ct->u.regs, reg)) {
                     goto oarg_end;
                 }
-                reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs);
+                reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs, args[i]);
             }
             tcg_regset_set_reg(allocated_regs, reg);
             /* if a fixed register is used, then a move will be done afterwards */
@@ -2304,13 +2323,13 @@ static int tcg_reg_alloc_call(TCGContext *s, const TCGOpDef *def,
                 tcg_out_st(s, ts->type, ts->reg, TCG_REG_CALL_STACK, stack_offset);
             } else if (ts->val_type == TEMP_VAL_MEM) {
                 reg = tcg_reg_alloc(s, tcg_target_available_regs[ts->type], 
-                                    s->reserved_regs);
+                                    s->reserved_regs, -1);
                 /* XXX: not correct if reading values from the stack */
                 tcg_out_ld(s, ts->type, reg, ts->mem_reg, ts->mem_offset);
                 tcg_out_st(s, ts->type, reg, TCG_REG_CALL_STACK, stack_offset);
             } else if (ts->val_type == TEMP_VAL_CONST) {
                 reg = tcg_reg_alloc(s, tcg_target_available_regs[ts->type], 
-                                    s->reserved_regs);
+                                    s->reserved_regs, -1);
                 /* XXX: sign extend may be needed on some targets */
                 tcg_out_movi(s, ts->type, reg, ts->val);
                 tcg_out_st(s, ts->type, reg, TCG_REG_CALL_STACK, stack_offset);
@@ -2354,14 +2373,14 @@ static int tcg_reg_alloc_call(TCGContext *s, const TCGOpDef *def,
     func_addr = ts->val;
     const_func_arg = 0;
     if (ts->val_type == TEMP_VAL_MEM) {
-        reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs);
+        reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs, -1);
         tcg_out_ld(s, ts->type, reg, ts->mem_reg, ts->mem_offset);
         func_arg = reg;
         tcg_regset_set_reg(allocated_regs, reg);
     } else if (ts->val_type == TEMP_VAL_REG) {
         reg = ts->reg;
         if (!tcg_regset_test_reg(arg_ct->u.regs, reg)) {
-            reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs);
+            reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs, -1);
             tcg_out_mov(s, ts->type, reg, ts->reg);
         }
         func_arg = reg;
@@ -2371,7 +2390,7 @@ static int tcg_reg_alloc_call(TCGContext *s, const TCGOpDef *def,
             const_func_arg = 1;
             func_arg = func_addr;
         } else {
-            reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs);
+            reg = tcg_reg_alloc(s, arg_ct->u.regs, allocated_regs, -1);
             tcg_out_movi(s, ts->type, reg, func_addr);
             func_arg = reg;
             tcg_regset_set_reg(allocated_regs, reg);
@@ -470,6 +470,10 @@ struct TCGContext {
        into account fixed registers */
     int reg_to_temp[TCG_TARGET_NB_REGS];
     TCGRegSet reserved_regs;
+    /* Set by the front end when the helpers it calls are mostly
+       TCG_CALL_NO_RWG: globals are then allocated to call saved host
+       registers first, which keeps them live across these calls.  */
+    bool globals_in_saved_regs;
     intptr_t current_frame_offset;
     intptr_t frame_start;
     intptr_t frame_end;
@@ -516,6 +520,9 @@ struct TCGContext {
     /* Code generation */
     int code_gen_max_blocks;
     uint8_t *code_gen_prologue;
+    /* Entry point used by goto_ptr to return to the main loop with
+       a zero return value (no TB to chain to).  */
+    uint8_t *code_gen_epilogue;
     uint8_t *code_gen_buffer;
     size_t code_gen_buffer_size;
     /* threshold to flush the translated code buffer */
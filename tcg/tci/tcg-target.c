@@ -542,11 +542,83 @@ static void tcg_out_movi(TCGContext *s, TCGType type,
     old_code_ptr[1] = s->code_ptr - old_code_ptr;
 }
 
+#if TCI_THREADED
+/* Write a pre-decoded operation if there is one for opc and its
+   operands. Returns false if the generic opcode must be used. */
+static bool tci_out_fast(TCGContext *s, TCGOpcode opc, const TCGArg *args,
+                         const int *const_args)
+{
+    uint8_t *old_code_ptr = s->code_ptr;
+    int fast;
+
+    switch (opc) {
+    case INDEX_op_add_i32:
+        fast = TCI_OPC_add_i32_rr;
+        break;
+    case INDEX_op_sub_i32:
+        fast = TCI_OPC_sub_i32_rr;
+        break;
+    case INDEX_op_and_i32:
+        fast = TCI_OPC_and_i32_rr;
+        break;
+    case INDEX_op_or_i32:
+        fast = TCI_OPC_or_i32_rr;
+        break;
+    case INDEX_op_xor_i32:
+        fast = TCI_OPC_xor_i32_rr;
+        break;
+    case INDEX_op_shl_i32:
+        fast = TCI_OPC_shl_i32_rr;
+        break;
+    case INDEX_op_shr_i32:
+        fast = TCI_OPC_shr_i32_rr;
+        break;
+    case INDEX_op_sar_i32:
+        fast = TCI_OPC_sar_i32_rr;
+        break;
+    case INDEX_op_brcond_i32:
+        tcg_out_op_t(s, TCI_OPC_brcond_i32_rr + const_args[1]);
+        tcg_out_r(s, args[0]);
+        if (const_args[1]) {
+            tcg_out32(s, args[1]);
+        } else {
+            tcg_out_r(s, args[1]);
+        }
+        tcg_out8(s, args[2]);           /* condition */
+        tci_out_label(s, args[3]);
+        old_code_ptr[1] = s->code_ptr - old_code_ptr;
+        return true;
+    default:
+        return false;
+    }
+
+    if (const_args[1]) {
+        return false;
+    }
+    tcg_out_op_t(s, fast + const_args[2]);
+    tcg_out_r(s, args[0]);
+    tcg_out_r(s, args[1]);
+    if (const_args[2]) {
+        tcg_out32(s, args[2]);
+    } else {
+        tcg_out_r(s, args[2]);
+    }
+    old_code_ptr[1] = s->code_ptr - old_code_ptr;
+    return true;
+}
+#endif
+
 static void tcg_out_op(TCGContext *s, TCGOpcode opc, const TCGArg *args,
                        const int *const_args)
 {
     uint8_t *old_code_ptr = s->code_ptr;
 
+#if TCI_THREADED
+    if (tci_out_fast(s, opc, args, const_args)) {
+        return;
+    }
+#endif
+
     tcg_out_op_t(s, opc);
 
     switch (opc) {
@@ -877,6 +949,9 @@ static void tcg_target_init(TCGContext *s)
 
     /* The current code uses uint8_t for tcg operations. */
     assert(ARRAY_SIZE(tcg_op_defs) <= UINT8_MAX);
+#if TCI_THREADED
+    assert(TCI_NB_OPS <= UINT8_MAX);
+#endif
 
     /* Registers available for 32 bit operations. */
     tcg_regset_set32(tcg_target_available_regs[TCG_TYPE_I32], 0,
@@ -63,6 +63,45 @@
 #endif
 #endif
 
+/* Threaded dispatch needs labels as values (a GCC extension).
+   Build with -DTCI_NO_THREADING to get the plain switch interpreter,
+   e.g. as a baseline for tests/fies-bench. */
+#if defined(__GNUC__) && !defined(TCI_NO_THREADING)
+# define TCI_THREADED 1
+#else
+# define TCI_THREADED 0
+#endif
+
+#if TCI_THREADED
+/* Pre-decoded opcodes. The backend emits them instead of the generic
+   opcode when the first input is a register, so the interpreter reads a
+   fixed operand layout without checking for TCG_CONST:
+     xxx_rr: opc, size, t0, t1, t2
+     xxx_ri: opc, size, t0, t1, 32 bit constant
+     brcond_i32_rr: opc, size, t0, t1, cond, label
+     brcond_i32_ri: opc, size, t0, 32 bit constant, cond, label
+   They are numbered after the TCG opcodes, each _ri right after its _rr. */
+#define TCI_OPC_add_i32_rr      (NB_OPS + 0)
+#define TCI_OPC_add_i32_ri      (NB_OPS + 1)
+#define TCI_OPC_sub_i32_rr      (NB_OPS + 2)
+#define TCI_OPC_sub_i32_ri      (NB_OPS + 3)
+#define TCI_OPC_and_i32_rr      (NB_OPS + 4)
+#define TCI_OPC_and_i32_ri      (NB_OPS + 5)
+#define TCI_OPC_or_i32_rr       (NB_OPS + 6)
+#define TCI_OPC_or_i32_ri       (NB_OPS + 7)
+#define TCI_OPC_xor_i32_rr      (NB_OPS + 8)
+#define TCI_OPC_xor_i32_ri      (NB_OPS + 9)
+#define TCI_OPC_shl_i32_rr      (NB_OPS + 10)
+#define TCI_OPC_shl_i32_ri      (NB_OPS + 11)
+#define TCI_OPC_shr_i32_rr      (NB_OPS + 12)
+#define TCI_OPC_shr_i32_ri      (NB_OPS + 13)
+#define TCI_OPC_sar_i32_rr      (NB_OPS + 14)
+#define TCI_OPC_sar_i32_ri      (NB_OPS + 15)
+#define TCI_OPC_brcond_i32_rr   (NB_OPS + 16)
+#define TCI_OPC_brcond_i32_ri   (NB_OPS + 17)
+#define TCI_NB_OPS              (NB_OPS + 18)
+#endif
+
 /* Optional instructions. */
 
 #define TCG_TARGET_HAS_bswap16_i32      1
@@ -121,6 +160,7 @@
 #endif /* TCG_TARGET_REG_BITS == 64 */
 
 #define TCG_TARGET_HAS_new_ldst         0
+#define TCG_TARGET_HAS_goto_ptr         0
 
 /* Number of registers available.
    For 32 bit hosts, we need more than 8 registers (call arguments). */
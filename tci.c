@@ -439,16 +439,55 @@ uintptr_t tcg_qemu_tb_exec(CPUArchState *env, uint8_t *tb_ptr)
     long tcg_temps[CPU_TEMP_BUF_NLONGS];
     uintptr_t sp_value = (uintptr_t)(tcg_temps + CPU_TEMP_BUF_NLONGS);
     uintptr_t next_tb = 0;
+#if TCI_THREADED
+    /* Handlers of the pre-decoded and other fixed layout operations,
+       indexed by opcode byte. Everything else goes through the switch. */
+    static const void *const dispatch[256] = {
+        [0 ... 255] = &&generic,
+        [TCI_OPC_add_i32_rr] = &&add_i32_rr,
+        [TCI_OPC_add_i32_ri] = &&add_i32_ri,
+        [TCI_OPC_sub_i32_rr] = &&sub_i32_rr,
+        [TCI_OPC_sub_i32_ri] = &&sub_i32_ri,
+        [TCI_OPC_and_i32_rr] = &&and_i32_rr,
+        [TCI_OPC_and_i32_ri] = &&and_i32_ri,
+        [TCI_OPC_or_i32_rr] = &&or_i32_rr,
+        [TCI_OPC_or_i32_ri] = &&or_i32_ri,
+        [TCI_OPC_xor_i32_rr] = &&xor_i32_rr,
+        [TCI_OPC_xor_i32_ri] = &&xor_i32_ri,
+        [TCI_OPC_shl_i32_rr] = &&shl_i32_rr,
+        [TCI_OPC_shl_i32_ri] = &&shl_i32_ri,
+        [TCI_OPC_shr_i32_rr] = &&shr_i32_rr,
+        [TCI_OPC_shr_i32_ri] = &&shr_i32_ri,
+        [TCI_OPC_sar_i32_rr] = &&sar_i32_rr,
+        [TCI_OPC_sar_i32_ri] = &&sar_i32_ri,
+        [TCI_OPC_brcond_i32_rr] = &&brcond_i32_rr,
+        [TCI_OPC_brcond_i32_ri] = &&brcond_i32_ri,
+#if TCG_TARGET_REG_BITS == 32
+        [INDEX_op_mov_i32] = &&mov,
+#else
+        [INDEX_op_mov_i64] = &&mov,
+        [INDEX_op_ld_i64] = &&ld_i64,
+        [INDEX_op_st_i64] = &&st_i64,
+#endif
+        [INDEX_op_movi_i32] = &&movi_i32,
+        [INDEX_op_ld_i32] = &&ld_i32,
+        [INDEX_op_st_i32] = &&st_i32,
+        [INDEX_op_br] = &&br,
+        [INDEX_op_goto_tb] = &&goto_tb,
+        [INDEX_op_exit_tb] = &&exit_tb,
+    };
+    uint32_t u1, u2;
+#endif
 
     tci_reg[TCG_AREG0] = (tcg_target_ulong)env;
     tci_reg[TCG_REG_CALL_STACK] = sp_value;
     assert(tb_ptr);
 
     for (;;) {
-        TCGOpcode opc = tb_ptr[0];
+        TCGOpcode opc;
 #if !defined(NDEBUG)
-        uint8_t op_size = tb_ptr[1];
-        uint8_t *old_code_ptr = tb_ptr;
+        uint8_t op_size;
+        uint8_t *old_code_ptr;
 #endif
         tcg_target_ulong t0;
         tcg_target_ulong t1;
@@ -467,6 +506,15 @@ uintptr_t tcg_qemu_tb_exec(CPUArchState *env, uint8_t *tb_ptr)
         uint64_t v64;
 #endif
 
+#if TCI_THREADED
+        goto *dispatch[tb_ptr[0]];
+    generic:
+#endif
+        opc = tb_ptr[0];
+#if !defined(NDEBUG)
+        op_size = tb_ptr[1];
+        old_code_ptr = tb_ptr;
+#endif
 #if defined(GETPC)
         tci_tb_ptr = (uintptr_t)tb_ptr;
 #endif
@@ -1232,6 +1280,92 @@ uintptr_t tcg_qemu_tb_exec(CPUArchState *env, uint8_t *tb_ptr)
         }
         assert(tb_ptr == old_code_ptr + op_size);
     }
+
+#if TCI_THREADED
+    /* None of these calls a helper, so tci_tb_ptr is not updated. */
+#define TCI_NEXT() goto *dispatch[tb_ptr[0]]
+#define TCI_OP_I32(name, expr) \
+name##_rr: \
+    u1 = tci_read_reg32(tb_ptr[3]); \
+    u2 = tci_read_reg32(tb_ptr[4]); \
+    tci_write_reg32(tb_ptr[2], expr); \
+    tb_ptr += 5; \
+    TCI_NEXT(); \
+name##_ri: \
+    u1 = tci_read_reg32(tb_ptr[3]); \
+    u2 = *(uint32_t *)(tb_ptr + 4); \
+    tci_write_reg32(tb_ptr[2], expr); \
+    tb_ptr += 8; \
+    TCI_NEXT();
+
+    TCI_OP_I32(add_i32, u1 + u2)
+    TCI_OP_I32(sub_i32, u1 - u2)
+    TCI_OP_I32(and_i32, u1 & u2)
+    TCI_OP_I32(or_i32, u1 | u2)
+    TCI_OP_I32(xor_i32, u1 ^ u2)
+    TCI_OP_I32(shl_i32, u1 << u2)
+    TCI_OP_I32(shr_i32, u1 >> u2)
+    TCI_OP_I32(sar_i32, (int32_t)u1 >> u2)
+
+brcond_i32_rr:
+    u1 = tci_read_reg32(tb_ptr[2]);
+    u2 = tci_read_reg32(tb_ptr[3]);
+    if (tci_compare32(u1, u2, tb_ptr[4])) {
+        tb_ptr = (uint8_t *)*(tcg_target_ulong *)(tb_ptr + 5);
+    } else {
+        tb_ptr += 5 + sizeof(tcg_target_ulong);
+    }
+    TCI_NEXT();
+brcond_i32_ri:
+    u1 = tci_read_reg32(tb_ptr[2]);
+    u2 = *(uint32_t *)(tb_ptr + 3);
+    if (tci_compare32(u1, u2, tb_ptr[7])) {
+        tb_ptr = (uint8_t *)*(tcg_target_ulong *)(tb_ptr + 8);
+    } else {
+        tb_ptr += 8 + sizeof(tcg_target_ulong);
+    }
+    TCI_NEXT();
+mov:
+    tci_write_reg(tb_ptr[2], tci_read_reg(tb_ptr[3]));
+    tb_ptr += 4;
+    TCI_NEXT();
+movi_i32:
+    tci_write_reg32(tb_ptr[2], *(uint32_t *)(tb_ptr + 3));
+    tb_ptr += 7;
+    TCI_NEXT();
+ld_i32:
+    tci_write_reg32(tb_ptr[2], *(uint32_t *)(tci_read_reg(tb_ptr[3]) +
+                                             *(int32_t *)(tb_ptr + 4)));
+    tb_ptr += 8;
+    TCI_NEXT();
+st_i32:
+    *(uint32_t *)(tci_read_reg(tb_ptr[3]) + *(int32_t *)(tb_ptr + 4)) =
+        tci_read_reg32(tb_ptr[2]);
+    tb_ptr += 8;
+    TCI_NEXT();
+#if TCG_TARGET_REG_BITS == 64
+ld_i64:
+    tci_write_reg64(tb_ptr[2], *(uint64_t *)(tci_read_reg(tb_ptr[3]) +
+                                             *(int32_t *)(tb_ptr + 4)));
+    tb_ptr += 8;
+    TCI_NEXT();
+st_i64:
+    *(uint64_t *)(tci_read_reg(tb_ptr[3]) + *(int32_t *)(tb_ptr + 4)) =
+        tci_read_reg64(tb_ptr[2]);
+    tb_ptr += 8;
+    TCI_NEXT();
+#endif
+br:
+    tb_ptr = (uint8_t *)*(tcg_target_ulong *)(tb_ptr + 2);
+    TCI_NEXT();
+goto_tb:
+    tb_ptr += 6 + *(int32_t *)(tb_ptr + 2);
+    TCI_NEXT();
+exit_tb:
+    next_tb = *(uint64_t *)(tb_ptr + 2);
+#undef TCI_OP_I32
+#undef TCI_NEXT
+#endif
 exit:
     return next_tb;
 }
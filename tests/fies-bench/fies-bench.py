@@ -0,0 +1,302 @@
+#!/usr/bin/env python
+#
+# FIES benchmark suite
+#
+# Runs a set of ARM workloads under a matrix of fault injection
+# configurations and reports guest MIPS, host time and peak RSS per
+# experiment as JSON, for tracking the overhead of the FIES hooks.
+#
+# This work is licensed under the terms of the GNU GPL, version 2 or later.
+# See the COPYING file in the top-level directory.
+
+from __future__ import print_function
+
+import json
+import optparse
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+SRC_DIR = os.path.dirname(os.path.abspath(__file__))
+SANDBOX_DIR = os.path.join(SRC_DIR, '..', '..', 'fies_sandbox', 'example_binaries')
+
+SANDBOX_WORKLOADS = ['hello_world', 'Basicmath_Small_Cubic']
+KERNEL_WORKLOADS = ['reg-alu', 'mem-stream']
+
+TRIGGERS = ['ACCESS', 'TIME', 'PC']
+FAULT_COUNTS = [1, 100, 10000]
+
+INSN_RE = re.compile(r'FIES: (\d+) guest instructions executed')
+
+# The generated faults are placed where the workloads never look (high
+# RAM, far-future times, unused PCs), so every run executes the same guest
+# code and only the cost of the FIES bookkeeping differs.
+FAULT_BASE_ADDRESS = 0x07000000
+FAULT_BASE_PC = 0x07800000
+
+FAULT_TEMPLATES = {
+    'ACCESS': '''\t<fault>
+\t\t<id>%(id)d</id>
+\t\t<component>RAM</component>
+\t\t<target>MEMORY CELL</target>
+\t\t<mode>SF</mode>
+\t\t<trigger>ACCESS</trigger>
+\t\t<type>PERMANENT</type>
+\t\t<params>
+\t\t\t<address>0x%(address)08x</address>
+\t\t\t<mask>0x1</mask>
+\t\t\t<set_bit>0x1</set_bit>
+\t\t</params>
+\t</fault>
+''',
+    'TIME': '''\t<fault>
+\t\t<id>%(id)d</id>
+\t\t<component>REGISTER</component>
+\t\t<target>REGISTER CELL</target>
+\t\t<mode>BIT-FLIP</mode>
+\t\t<trigger>TIME</trigger>
+\t\t<timer>%(start)dMS</timer>
+\t\t<type>TRANSIENT</type>
+\t\t<duration>%(stop)dMS</duration>
+\t\t<params>
+\t\t\t<address>0x%(reg)x</address>
+\t\t\t<mask>0x1</mask>
+\t\t</params>
+\t</fault>
+''',
+    'PC': '''\t<fault>
+\t\t<id>%(id)d</id>
+\t\t<component>RAM</component>
+\t\t<target>MEMORY CELL</target>
+\t\t<mode>NEW VALUE</mode>
+\t\t<trigger>PC</trigger>
+\t\t<type>PERMANENT</type>
+\t\t<params>
+\t\t\t<address>0x%(address)08x</address>
+\t\t\t<mask>0x0</mask>
+\t\t\t<instruction>0x%(pc)08x</instruction>
+\t\t</params>
+\t</fault>
+''',
+}
+
+
+def write_fault_library(path, trigger, count):
+    with open(path, 'w') as f:
+        f.write('<?xml version="1.0" encoding="UTF-8"?>\n<injection>\n')
+        for i in range(count):
+            f.write(FAULT_TEMPLATES[trigger] % {
+                'id': i + 1,
+                'address': FAULT_BASE_ADDRESS + 4 * i,
+                'pc': FAULT_BASE_PC + 4 * i,
+                'reg': i % 13,
+                'start': 10000000 + i,
+                'stop': 10000001 + i,
+            })
+        f.write('</injection>\n')
+
+
+def build_kernels(cross_prefix, outdir):
+    '''Build the synthetic kernels; returns {name: path or None}.'''
+    cc = cross_prefix + 'gcc'
+    kernels = {}
+    for name in KERNEL_WORKLOADS:
+        src = os.path.join(SRC_DIR, 'kernels', name + '.S')
+        out = os.path.join(outdir, name)
+        try:
+            subprocess.check_call([cc, '-nostdlib', '-static', '-marm',
+                                   '-Wl,-Ttext=0x10000', '-o', out, src])
+            kernels[name] = out
+        except (OSError, subprocess.CalledProcessError):
+            kernels[name] = None
+    return kernels
+
+
+def configurations():
+    '''Yield (name, trigger, fault count, extra qemu arguments).'''
+    yield ('no-fi', None, 0, [])
+    yield ('profiling', None, 0, ['-profiling', 'rm'])
+    for trigger in TRIGGERS:
+        for count in FAULT_COUNTS:
+            yield ('fi-%s-%d' % (trigger.lower(), count), trigger, count, None)
+
+
+def run_once(qemu, binary, extra_args, workdir, timeout):
+    '''Run one experiment; returns (status, seconds, peak RSS in KiB,
+    guest instructions or None).'''
+    args = [qemu, '-semihosting', '-display', 'none', '-monitor', 'none',
+            '-serial', 'none', '-kernel', binary] + extra_args
+    # -profiling takes the letters as one argument; add 'i' to it
+    if '-profiling' in args:
+        i = args.index('-profiling') + 1
+        args[i] += 'i'
+    else:
+        args += ['-profiling', 'i']
+
+    errfile = tempfile.TemporaryFile(dir=workdir)
+    start = time.time()
+    proc = subprocess.Popen(args, cwd=workdir, stdout=open(os.devnull, 'w'),
+                            stderr=errfile)
+    status = None
+    while status is None:
+        pid, wstatus, rusage = os.wait4(proc.pid, os.WNOHANG)
+        if pid == proc.pid:
+            status = wstatus
+            break
+        if time.time() - start > timeout:
+            proc.kill()
+            pid, wstatus, rusage = os.wait4(proc.pid, 0)
+            status = 'timeout'
+            break
+        time.sleep(0.01)
+    elapsed = time.time() - start
+    # Mark the Popen object as reaped
+    proc.returncode = 0
+
+    errfile.seek(0)
+    stderr = errfile.read().decode('utf-8', 'replace')
+    errfile.close()
+    m = INSN_RE.search(stderr)
+    insns = int(m.group(1)) if m else None
+
+    if status != 'timeout':
+        status = os.WEXITSTATUS(status) if os.WIFEXITED(status) else \
+            -os.WTERMSIG(status)
+    # ru_maxrss is in KiB on Linux
+    return status, elapsed, rusage.ru_maxrss, insns
+
+
+def median(values):
+    values = sorted(values)
+    n = len(values)
+    if n % 2:
+        return values[n // 2]
+    return (values[n // 2 - 1] + values[n // 2]) / 2.0
+
+
+def measure(qemu, binary, extra, workdir, opts, label):
+    '''Run one experiment opts.repeat times; returns its result fields.'''
+    times, rss, insns, statuses = [], 0, None, []
+    for i in range(opts.repeat):
+        status, elapsed, maxrss, n = \
+            run_once(qemu, binary, extra, workdir, opts.timeout)
+        statuses.append(status)
+        times.append(elapsed)
+        rss = max(rss, maxrss)
+        insns = n if n is not None else insns
+        print('%-24s %8.3fs' % (label, elapsed), file=sys.stderr)
+
+    host_time = median(times)
+    return {
+        'exit_status': statuses,
+        'host_time_s': host_time,
+        'host_times_s': times,
+        'peak_rss_kib': rss,
+        'guest_insns': insns,
+        'guest_mips': (insns / host_time / 1e6)
+        if insns and host_time > 0 else None,
+    }
+
+
+def main():
+    parser = optparse.OptionParser(usage='%prog [options]')
+    parser.add_option('--qemu', default='arm-softmmu/qemu-system-arm',
+                      help='qemu-system-arm binary to benchmark')
+    parser.add_option('--output', default='-',
+                      help='JSON output file (default: stdout)')
+    parser.add_option('--cross-prefix', default='arm-none-eabi-',
+                      help='ARM cross toolchain prefix for the kernels')
+    parser.add_option('--repeat', type='int', default=3,
+                      help='runs per experiment; the median time is used')
+    parser.add_option('--timeout', type='float', default=600,
+                      help='seconds before an experiment is killed')
+    parser.add_option('--workload', action='append', default=None,
+                      help='only run the given workload (repeatable)')
+    parser.add_option('--config', action='append', default=None,
+                      help='only run the given configuration (repeatable)')
+    parser.add_option('--baseline', default=None,
+                      help='also run every experiment with this binary and '
+                      'report the speedup over it')
+    opts, args = parser.parse_args()
+
+    qemu = os.path.abspath(opts.qemu)
+    if not os.access(qemu, os.X_OK):
+        parser.error('%s is not executable' % qemu)
+    baseline = None
+    if opts.baseline:
+        baseline = os.path.abspath(opts.baseline)
+        if not os.access(baseline, os.X_OK):
+            parser.error('%s is not executable' % baseline)
+
+    workdir = tempfile.mkdtemp(prefix='fies-bench-')
+    try:
+        workloads = []
+        for name in SANDBOX_WORKLOADS:
+            workloads.append((name, os.path.abspath(
+                os.path.join(SANDBOX_DIR, name))))
+        for name, path in sorted(build_kernels(opts.cross_prefix,
+                                               workdir).items()):
+            workloads.append((name, path))
+
+        results = []
+        for wname, binary in workloads:
+            if opts.workload and wname not in opts.workload:
+                continue
+            for cname, trigger, count, extra in configurations():
+                if opts.config and cname not in opts.config:
+                    continue
+                entry = {'workload': wname, 'config': cname,
+                         'trigger': trigger, 'faults': count}
+                if binary is None:
+                    entry['skipped'] = 'could not build with %sgcc' % \
+                        opts.cross_prefix
+                    results.append(entry)
+                    continue
+                if extra is None:
+                    lib = os.path.join(workdir, '%s.xml' % cname)
+                    write_fault_library(lib, trigger, count)
+                    extra = ['-fi', lib]
+
+                label = '%-24s %-18s' % (wname, cname)
+                entry.update(measure(qemu, binary, extra, workdir, opts,
+                                     label))
+                if baseline:
+                    base = measure(baseline, binary, extra, workdir, opts,
+                                   label + ' (baseline)')
+                    entry['baseline'] = base
+                    entry['speedup'] = (base['host_time_s'] /
+                                        entry['host_time_s']) \
+                        if entry['host_time_s'] > 0 else None
+                results.append(entry)
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    report = {
+        'qemu': qemu,
+        'baseline': baseline,
+        'host': platform.node(),
+        'machine': platform.machine(),
+        'date': time.strftime('%Y-%m-%dT%H:%M:%S'),
+        'repeat': opts.repeat,
+        'results': results,
+    }
+    text = json.dumps(report, indent=2, sort_keys=True)
+    if opts.output == '-':
+        print(text)
+    else:
+        with open(opts.output, 'w') as f:
+            f.write(text + '\n')
+
+    failed = [r for r in results
+              if any(s != 0 for s in r.get('exit_status', []) +
+                     r.get('baseline', {}).get('exit_status', []))]
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,192 @@
+#!/usr/bin/env python
+#
+# FIES rollback test
+#
+# Checks that an experiment started with fault-rollback (-fi-journal)
+# behaves exactly like the same experiment in a fresh QEMU process: the
+# semihosting console output and the number of executed guest instructions
+# (-profiling i) have to be the same.
+#
+# The rolled back process first runs another experiment and interrupts it
+# part way, so that guest RAM, the CPU, the timers and the other devices
+# are all left in a different state than after the reset.
+#
+# This work is licensed under the terms of the GNU GPL, version 2 or later.
+# See the COPYING file in the top-level directory.
+
+from __future__ import print_function
+
+import json
+import optparse
+import os
+import shutil
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+SRC_DIR = os.path.dirname(os.path.abspath(__file__))
+SANDBOX_DIR = os.path.join(SRC_DIR, '..', 'fies_sandbox')
+
+
+class QMP(object):
+    '''Minimal QMP client on a listening unix socket.'''
+
+    def __init__(self, path):
+        self.listener = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.listener.bind(path)
+        self.listener.listen(1)
+        self.sock = None
+        self.buf = b''
+
+    def accept(self, timeout):
+        self.listener.settimeout(timeout)
+        self.sock, _ = self.listener.accept()
+        self.sock.settimeout(timeout)
+        self.read()                     # greeting
+        self.command('qmp_capabilities')
+
+    def read(self):
+        while b'\n' not in self.buf:
+            data = self.sock.recv(4096)
+            if not data:
+                raise Exception('QMP connection closed')
+            self.buf += data
+        line, self.buf = self.buf.split(b'\n', 1)
+        return json.loads(line.decode('utf-8'))
+
+    def command(self, name, **args):
+        msg = {'execute': name}
+        if args:
+            msg['arguments'] = args
+        self.sock.sendall(json.dumps(msg).encode('utf-8'))
+        while True:
+            resp = self.read()
+            if 'error' in resp:
+                raise Exception('%s: %s' % (name, resp['error']['desc']))
+            if 'return' in resp:
+                return resp['return']
+
+    def hmp(self, command_line):
+        return self.command('human-monitor-command', **{
+            'command-line': command_line})
+
+    def close(self):
+        if self.sock:
+            self.sock.close()
+        self.listener.close()
+
+
+def start(args, workdir, name, extra):
+    '''Start QEMU with its output in workdir/name.out and .err.'''
+    out = open(os.path.join(workdir, name + '.out'), 'wb')
+    err = open(os.path.join(workdir, name + '.err'), 'wb')
+    return subprocess.Popen(args + extra, cwd=workdir, stdout=out,
+                            stderr=err)
+
+
+def wait(proc, timeout):
+    start = time.time()
+    while proc.poll() is None:
+        if time.time() - start > timeout:
+            proc.kill()
+            proc.wait()
+            raise Exception('QEMU did not exit within %d seconds' % timeout)
+        time.sleep(0.01)
+    return proc.returncode
+
+
+def output(workdir, name, skip=(0, 0)):
+    '''The console output and stderr of a run, without the first bytes.'''
+    result = []
+    for ext, n in zip(('.out', '.err'), skip):
+        with open(os.path.join(workdir, name + ext), 'rb') as f:
+            f.seek(n)
+            result.append(f.read())
+    return result
+
+
+def output_sizes(workdir, name):
+    return tuple(os.path.getsize(os.path.join(workdir, name + ext))
+                 for ext in ('.out', '.err'))
+
+
+def main():
+    parser = optparse.OptionParser(usage='%prog [options] [-- qemu args]')
+    parser.add_option('--qemu', default='arm-softmmu/qemu-system-arm',
+                      help='qemu-system-arm binary to test')
+    parser.add_option('--kernel', default=os.path.join(
+        SANDBOX_DIR, 'example_binaries', 'Basicmath_Small_Cubic'),
+                      help='guest binary of the experiments')
+    parser.add_option('--first', default=os.path.join(
+        SANDBOX_DIR, 'fault_examples.xml'),
+                      help='fault library of the interrupted experiment')
+    parser.add_option('--faults', default=os.path.join(
+        SANDBOX_DIR, 'fault_memory_cell_saf.xml'),
+                      help='fault library of the compared experiment')
+    parser.add_option('--interrupt-after', type='float', default=0.2,
+                      help='seconds after which the first experiment is '
+                      'stopped')
+    parser.add_option('--timeout', type='float', default=600,
+                      help='seconds before an experiment is killed')
+    opts, extra = parser.parse_args()
+
+    qemu = os.path.abspath(opts.qemu)
+    if not os.access(qemu, os.X_OK):
+        parser.error('%s is not executable' % qemu)
+    faults = os.path.abspath(opts.faults)
+    args = [qemu, '-semihosting', '-display', 'none', '-monitor', 'none',
+            '-serial', 'none', '-profiling', 'i',
+            '-kernel', os.path.abspath(opts.kernel)] + extra
+
+    workdir = tempfile.mkdtemp(prefix='fies-rollback-')
+    qmp = None
+    try:
+        # The reference: the experiment in a fresh process
+        wait(start(args, workdir, 'fresh', ['-fi', faults]), opts.timeout)
+
+        # Interrupt another experiment, roll back and run the same one
+        qmp = QMP(os.path.join(workdir, 'qmp.sock'))
+        proc = start(args, workdir, 'rollback',
+                     ['-S', '-fi-journal', '-fi',
+                      os.path.abspath(opts.first),
+                      '-qmp', 'unix:' + os.path.join(workdir, 'qmp.sock')])
+        qmp.accept(opts.timeout)
+        qmp.command('cont')
+        time.sleep(opts.interrupt_after)
+        if proc.poll() is not None:
+            raise Exception('the first experiment ended before it was '
+                            'interrupted, try a smaller --interrupt-after')
+        qmp.command('stop')
+        skip = output_sizes(workdir, 'rollback')
+
+        qmp.command('fault-rollback')
+        out = qmp.hmp('fault_reload ' + faults)
+        if 'loaded successfully' not in out:
+            raise Exception('fault_reload: %s' % out.strip())
+        qmp.command('cont')
+        wait(proc, opts.timeout)
+
+        fresh = output(workdir, 'fresh')
+        rolled_back = output(workdir, 'rollback', skip)
+        for what, a, b in zip(('console output', 'stderr'), fresh,
+                              rolled_back):
+            if a != b:
+                print('%s differs after fault-rollback:' % what,
+                      file=sys.stderr)
+                print('--- fresh process\n%s\n--- after rollback\n%s' %
+                      (a.decode('utf-8', 'replace'),
+                       b.decode('utf-8', 'replace')), file=sys.stderr)
+                return 1
+        print('fault-rollback: same result as a fresh process',
+              file=sys.stderr)
+        return 0
+    finally:
+        if qmp:
+            qmp.close()
+        shutil.rmtree(workdir)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,256 @@
+#!/usr/bin/env python
+#
+# -tb-prefetch test
+#
+# Boots a small guest on the integratorcp board that halts in WFI before
+# it has run one side of a conditional branch.  A timer interrupt wakes it
+# up and it then takes the branch.  The block at the branch target has to
+# be translated while the CPU was halted and found in the physical TB hash
+# table when it is reached, which "info jit" reports as a prefetch hit.
+#
+# This work is licensed under the terms of the GNU GPL, version 2 or later.
+# See the COPYING file in the top-level directory.
+
+from __future__ import print_function
+
+import json
+import optparse
+import os
+import re
+import shutil
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+# The bootloader of the integratorcp board jumps to a raw kernel image here
+KERNEL_ADDR = 0x10000
+TIMER1 = 0x13000100
+PIC = 0x14000000
+# Set by the guest once it has taken the branch
+MARKER = 0x8000
+
+
+def imm(value):
+    '''An ARM data processing immediate (8 bits rotated right by 2n).'''
+    for rot in range(16):
+        v = ((value << (2 * rot)) | (value >> (32 - 2 * rot))) & 0xffffffff
+        if v < 0x100:
+            return rot << 8 | v
+    raise ValueError('%#x is not an ARM immediate' % value)
+
+
+def mov(rd, value):
+    return 0xe3a00000 | rd << 12 | imm(value)
+
+
+def orr(rd, rn, value):
+    return 0xe3800000 | rn << 16 | rd << 12 | imm(value)
+
+
+def cmp(rn, value):
+    return 0xe3500000 | rn << 16 | imm(value)
+
+
+def str_(rt, rn, offset):
+    return 0xe5800000 | rn << 16 | rt << 12 | offset
+
+
+def branch(cond, addr, target):
+    return cond << 28 | 0x0a000000 | ((target - addr - 8) >> 2) & 0xffffff
+
+
+def b(addr, target):
+    return branch(0xe, addr, target)
+
+
+def bne(addr, target):
+    return branch(0x1, addr, target)
+
+
+# mcr p15, 0, r0, c7, c0, 4: wait for interrupt on the default arm926
+WFI = 0xee070f90
+
+
+def guest_image():
+    '''The guest, with the IRQ masked as after reset:
+
+            b       next_page       @ map the next page in the code TLB
+    main:   mov     r1, #TIMER1
+            orr     r1, r1, #0x100
+            mov     r0, #0x30000    @ about 0.2s at 1MHz
+            str     r0, [r1]        @ TimerLoad
+            mov     r0, #0xa3       @ enabled, IE, 32-bit, one shot
+            str     r0, [r1, #8]    @ TimerControl
+            mov     r2, #PIC
+            mov     r0, #0x40       @ timer 1
+            str     r0, [r2, #8]    @ IRQ_ENABLESET
+            mov     r3, #0
+    loop:   cmp     r3, #0
+            bne     taken           @ only queued before the WFI
+            wfi
+            mov     r3, #1
+            b       loop
+    taken:  str     r0, [r1, #12]   @ TimerIntClr
+            mov     r4, #MARKER
+            mov     r0, #1
+            str     r0, [r4]
+    halt:   wfi
+            b       halt
+
+    next_page:
+            b       main
+    '''
+    code = []
+
+    def emit(insn):
+        code.append(insn)
+        return KERNEL_ADDR + (len(code) - 1) * 4
+
+    def here():
+        return KERNEL_ADDR + len(code) * 4
+
+    next_page = KERNEL_ADDR + 0x1000
+    emit(b(here(), next_page))
+    main = here()
+    emit(mov(1, TIMER1 & ~0xfff))
+    emit(orr(1, 1, TIMER1 & 0xfff))
+    emit(mov(0, 0x30000))
+    emit(str_(0, 1, 0))
+    emit(mov(0, 0xa3))
+    emit(str_(0, 1, 8))
+    emit(mov(2, PIC))
+    emit(mov(0, 0x40))
+    emit(str_(0, 2, 8))
+    emit(mov(3, 0))
+    loop = here()
+    emit(cmp(3, 0))
+    bne_addr = emit(0)
+    emit(WFI)
+    emit(mov(3, 1))
+    emit(b(here(), loop))
+    taken = here()
+    code[(bne_addr - KERNEL_ADDR) // 4] = bne(bne_addr, taken)
+    emit(str_(0, 1, 12))
+    emit(mov(4, MARKER))
+    emit(mov(0, 1))
+    emit(str_(0, 4, 0))
+    halt = emit(WFI)
+    emit(b(here(), halt))
+
+    code += [0] * ((next_page - here()) // 4)
+    emit(b(here(), main))
+    return struct.pack('<%dI' % len(code), *code)
+
+
+class QMP(object):
+    '''Minimal QMP client on a listening unix socket.'''
+
+    def __init__(self, path):
+        self.listener = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.listener.bind(path)
+        self.listener.listen(1)
+        self.sock = None
+        self.buf = b''
+
+    def accept(self, timeout):
+        self.listener.settimeout(timeout)
+        self.sock, _ = self.listener.accept()
+        self.sock.settimeout(timeout)
+        self.read()                     # greeting
+        self.command('qmp_capabilities')
+
+    def read(self):
+        while b'\n' not in self.buf:
+            data = self.sock.recv(4096)
+            if not data:
+                raise Exception('QMP connection closed')
+            self.buf += data
+        line, self.buf = self.buf.split(b'\n', 1)
+        return json.loads(line.decode('utf-8'))
+
+    def command(self, name, **args):
+        msg = {'execute': name}
+        if args:
+            msg['arguments'] = args
+        self.sock.sendall(json.dumps(msg).encode('utf-8'))
+        while True:
+            resp = self.read()
+            if 'error' in resp:
+                raise Exception('%s: %s' % (name, resp['error']['desc']))
+            if 'return' in resp:
+                return resp['return']
+
+    def hmp(self, command_line):
+        return self.command('human-monitor-command', **{
+            'command-line': command_line})
+
+    def close(self):
+        if self.sock:
+            self.sock.close()
+        self.listener.close()
+
+
+def main():
+    parser = optparse.OptionParser(usage='%prog [options]')
+    parser.add_option('--qemu', default='arm-softmmu/qemu-system-arm',
+                      help='qemu-system-arm binary to test')
+    parser.add_option('--timeout', type='float', default=30,
+                      help='seconds before the guest is given up on')
+    opts, _ = parser.parse_args()
+
+    qemu = os.path.abspath(opts.qemu)
+    if not os.access(qemu, os.X_OK):
+        parser.error('%s is not executable' % qemu)
+
+    workdir = tempfile.mkdtemp(prefix='tb-prefetch-')
+    qmp = None
+    proc = None
+    try:
+        kernel = os.path.join(workdir, 'guest.bin')
+        with open(kernel, 'wb') as f:
+            f.write(guest_image())
+
+        qmp = QMP(os.path.join(workdir, 'qmp.sock'))
+        proc = subprocess.Popen(
+            [qemu, '-M', 'integratorcp', '-display', 'none',
+             '-monitor', 'none', '-serial', 'none', '-tb-prefetch', '64',
+             '-kernel', kernel,
+             '-qmp', 'unix:' + os.path.join(workdir, 'qmp.sock')],
+            cwd=workdir)
+        qmp.accept(opts.timeout)
+
+        start = time.time()
+        while not qmp.hmp('xp /1wx %#x' % MARKER).strip().endswith(
+                '0x00000001'):
+            if proc.poll() is not None:
+                raise Exception('QEMU exited with status %d' % proc.returncode)
+            if time.time() - start > opts.timeout:
+                raise Exception('the guest did not wake up from WFI')
+            time.sleep(0.05)
+
+        info = qmp.hmp('info jit')
+        m = re.search(r'TB prefetch count\s+(\d+) \((\d+) hit\)', info)
+        if not m:
+            raise Exception('no prefetch statistics in "info jit":\n' + info)
+        translated, hit = int(m.group(1)), int(m.group(2))
+        print('tb-prefetch: %d blocks translated ahead, %d hit' %
+              (translated, hit), file=sys.stderr)
+        if not translated or not hit:
+            print('the branch target was not translated while the CPU was '
+                  'halted', file=sys.stderr)
+            return 1
+        return 0
+    finally:
+        if qmp:
+            qmp.close()
+        if proc and proc.poll() is None:
+            proc.kill()
+            proc.wait()
+        shutil.rmtree(workdir)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
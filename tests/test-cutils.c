@@ -226,6 +226,26 @@ static void test_parse_uint_full_correct(void)
     g_assert_cmpint(i, ==, 123);
 }
 
+static void test_buffer_find_nonzero_offset(void)
+{
+    static uint8_t buf[4096] __attribute__((aligned(64)));
+    size_t i, offset;
+
+    g_assert(can_use_buffer_find_nonzero_offset(buf, sizeof(buf)));
+    g_assert_cmpint(buffer_find_nonzero_offset(buf, sizeof(buf)), ==,
+                    sizeof(buf));
+
+    /* The offset is rounded down by at most one unrolled loop iteration */
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = 1;
+        offset = buffer_find_nonzero_offset(buf, sizeof(buf));
+        g_assert_cmpint(offset, <=, i);
+        g_assert_cmpint(offset + 256, >, i);
+        g_assert(!buffer_is_zero(buf, sizeof(buf)));
+        buf[i] = 0;
+    }
+}
+
 int main(int argc, char **argv)
 {
     g_test_init(&argc, &argv, NULL);
@@ -246,6 +266,8 @@ int main(int argc, char **argv)
                     test_parse_uint_full_trailing);
     g_test_add_func("/cutils/parse_uint_full/correct",
                     test_parse_uint_full_correct);
+    g_test_add_func("/cutils/buffer_find_nonzero_offset",
+                    test_buffer_find_nonzero_offset);
 
     return g_test_run();
 }
@@ -0,0 +1,264 @@
+/*
+ * Compare the whole Q register NEON helpers with the per-D register ones.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+#include <glib.h>
+#include <string.h>
+#include "cpu.h"
+#include "helper.h"
+
+#define NUM_OPERANDS 10000
+
+/* Q0 = D0:D1 is the result, Q1 = D2:D3 and Q2 = D4:D5 the operands */
+#define QD 0
+#define QN 2
+#define QM 4
+
+typedef void QRegOp3(CPUARMState *env, uint32_t rd, uint32_t rn, uint32_t rm);
+typedef void QRegOp2(CPUARMState *env, uint32_t rd, uint32_t rm);
+typedef uint32_t DRegOp(uint32_t a, uint32_t b);
+typedef uint32_t DRegEnvOp(CPUARMState *env, uint32_t a, uint32_t b);
+typedef uint32_t DRegOp1(uint32_t a);
+
+typedef struct {
+    const char *name;
+    QRegOp3 *qreg;
+    DRegOp *dreg;
+    DRegEnvOp *dreg_env;
+} QRegOp3Test;
+
+typedef struct {
+    const char *name;
+    QRegOp3 *qreg;
+    int esize;
+    bool is_signed;
+    bool right;
+} QRegShiftTest;
+
+typedef struct {
+    const char *name;
+    QRegOp2 *qreg;
+    DRegOp1 *dreg;
+} QRegOp2Test;
+
+/* 32-bit lanes are handled by TCG ops rather than helpers */
+static uint32_t ref_add_u32(uint32_t a, uint32_t b)
+{
+    return a + b;
+}
+
+static uint32_t ref_sub_u32(uint32_t a, uint32_t b)
+{
+    return a - b;
+}
+
+static uint32_t ref_mul_u32(uint32_t a, uint32_t b)
+{
+    return a * b;
+}
+
+static uint32_t ref_abs_s32(uint32_t a)
+{
+    return (int32_t)a < 0 ? -a : a;
+}
+
+#define OP3(n)      { #n, helper_neon_qreg_##n, helper_neon_##n, NULL }
+#define OP3_REF(n)  { #n, helper_neon_qreg_##n, ref_##n, NULL }
+#define OP3_ENV(n)  { #n, helper_neon_qreg_##n, NULL, helper_neon_##n }
+
+static const QRegOp3Test ops3[] = {
+    OP3(add_u8), OP3(add_u16), OP3_REF(add_u32),
+    OP3(sub_u8), OP3(sub_u16), OP3_REF(sub_u32),
+    OP3(mul_u8), OP3(mul_u16), OP3_REF(mul_u32),
+    OP3_ENV(qadd_s8), OP3_ENV(qadd_u8), OP3_ENV(qadd_s16), OP3_ENV(qadd_u16),
+    OP3_ENV(qsub_s8), OP3_ENV(qsub_u8), OP3_ENV(qsub_s16), OP3_ENV(qsub_u16),
+    OP3(ceq_u8), OP3(ceq_u16), OP3(ceq_u32),
+    OP3(tst_u8), OP3(tst_u16), OP3(tst_u32),
+    OP3(cgt_s8), OP3(cgt_u8), OP3(cgt_s16),
+    OP3(cgt_u16), OP3(cgt_s32), OP3(cgt_u32),
+    OP3(cge_s8), OP3(cge_u8), OP3(cge_s16),
+    OP3(cge_u16), OP3(cge_s32), OP3(cge_u32),
+    OP3(max_s8), OP3(max_u8), OP3(max_s16),
+    OP3(max_u16), OP3(max_s32), OP3(max_u32),
+    OP3(min_s8), OP3(min_u8), OP3(min_s16),
+    OP3(min_u16), OP3(min_s32), OP3(min_u32),
+};
+
+static const QRegShiftTest shifts[] = {
+    { "shl_u16", helper_neon_qreg_shl_u16, 16, false, false },
+    { "shl_u32", helper_neon_qreg_shl_u32, 32, false, false },
+    { "shl_u64", helper_neon_qreg_shl_u64, 64, false, false },
+    { "shr_u16", helper_neon_qreg_shr_u16, 16, false, true },
+    { "shr_u32", helper_neon_qreg_shr_u32, 32, false, true },
+    { "shr_u64", helper_neon_qreg_shr_u64, 64, false, true },
+    { "shr_s16", helper_neon_qreg_shr_s16, 16, true, true },
+    { "shr_s32", helper_neon_qreg_shr_s32, 32, true, true },
+};
+
+static const QRegOp2Test ops2[] = {
+    { "abs_s8", helper_neon_qreg_abs_s8, helper_neon_abs_s8 },
+    { "abs_s16", helper_neon_qreg_abs_s16, helper_neon_abs_s16 },
+    { "abs_s32", helper_neon_qreg_abs_s32, ref_abs_s32 },
+};
+
+static CPUARMState env, env_ref;
+
+static uint64_t rand64(void)
+{
+    return ((uint64_t)g_test_rand_int() << 32) | (uint32_t)g_test_rand_int();
+}
+
+/* Random operands; the second one often equals the first in most lanes,
+   so that the compares see equal lanes and saturation is near the edge */
+static void rand_operands(void)
+{
+    int i;
+
+    memset(&env, 0, sizeof(env));
+    for (i = 0; i < 2; i++) {
+        uint64_t a = rand64();
+        uint64_t b = g_test_rand_bit() ? a ^ (rand64() & rand64() & rand64())
+                                       : rand64();
+        env.vfp.regs[QN + i] = make_float64(a);
+        env.vfp.regs[QM + i] = make_float64(b);
+    }
+    env_ref = env;
+}
+
+static uint64_t dreg(CPUARMState *s, int reg)
+{
+    return float64_val(s->vfp.regs[reg]);
+}
+
+static void check_result(const char *name)
+{
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        if (dreg(&env, QD + i) != dreg(&env_ref, QD + i)) {
+            g_test_message("%s: D%d is %016" PRIx64 ", expected %016" PRIx64,
+                           name, QD + i, dreg(&env, QD + i),
+                           dreg(&env_ref, QD + i));
+        }
+        g_assert_cmphex(dreg(&env, QD + i), ==, dreg(&env_ref, QD + i));
+    }
+    g_assert_cmphex(env.vfp.xregs[ARM_VFP_FPSCR] & CPSR_Q, ==,
+                    env_ref.vfp.xregs[ARM_VFP_FPSCR] & CPSR_Q);
+}
+
+static void test_op3(gconstpointer opaque)
+{
+    const QRegOp3Test *t = opaque;
+    int n, i, w;
+
+    for (n = 0; n < NUM_OPERANDS; n++) {
+        rand_operands();
+        t->qreg(&env, QD, QN, QM);
+
+        for (i = 0; i < 2; i++) {
+            uint64_t a = dreg(&env_ref, QN + i), b = dreg(&env_ref, QM + i);
+            uint64_t r = 0;
+
+            for (w = 0; w < 2; w++) {
+                uint32_t x = a >> (w * 32), y = b >> (w * 32);
+                uint32_t z = t->dreg ? t->dreg(x, y)
+                                     : t->dreg_env(&env_ref, x, y);
+                r |= (uint64_t)z << (w * 32);
+            }
+            env_ref.vfp.regs[QD + i] = make_float64(r);
+        }
+        check_result(t->name);
+    }
+}
+
+/* The per-D register helpers shift each lane by the signed low byte of
+   the corresponding lane of the shift operand */
+static uint32_t shift_lanes(int esize, int8_t shift)
+{
+    return esize == 16 ? (uint8_t)shift * 0x00010001u : (uint8_t)shift;
+}
+
+static void test_shift(gconstpointer opaque)
+{
+    const QRegShiftTest *t = opaque;
+    int n, i, w, shift;
+
+    for (n = 0; n < NUM_OPERANDS; n++) {
+        rand_operands();
+        /* VSHL takes 0..esize-1, VSHR 1..esize */
+        shift = g_test_rand_int_range(t->right, t->esize + t->right);
+        t->qreg(&env, QD, QM, shift);
+
+        for (i = 0; i < 2; i++) {
+            uint64_t a = dreg(&env_ref, QM + i), r = 0;
+            int8_t s = t->right ? -shift : shift;
+
+            if (t->esize == 64) {
+                r = helper_neon_shl_u64(a, (uint8_t)s);
+            }
+            for (w = 0; t->esize < 64 && w < 2; w++) {
+                uint32_t x = a >> (w * 32), z;
+
+                if (t->esize == 16) {
+                    z = t->is_signed
+                        ? helper_neon_shl_s16(x, shift_lanes(16, s))
+                        : helper_neon_shl_u16(x, shift_lanes(16, s));
+                } else {
+                    z = t->is_signed
+                        ? helper_neon_shl_s32(x, shift_lanes(32, s))
+                        : helper_neon_shl_u32(x, shift_lanes(32, s));
+                }
+                r |= (uint64_t)z << (w * 32);
+            }
+            env_ref.vfp.regs[QD + i] = make_float64(r);
+        }
+        check_result(t->name);
+    }
+}
+
+static void test_op2(gconstpointer opaque)
+{
+    const QRegOp2Test *t = opaque;
+    int n, i, w;
+
+    for (n = 0; n < NUM_OPERANDS; n++) {
+        rand_operands();
+        t->qreg(&env, QD, QM);
+
+        for (i = 0; i < 2; i++) {
+            uint64_t a = dreg(&env_ref, QM + i), r = 0;
+
+            for (w = 0; w < 2; w++) {
+                r |= (uint64_t)t->dreg(a >> (w * 32)) << (w * 32);
+            }
+            env_ref.vfp.regs[QD + i] = make_float64(r);
+        }
+        check_result(t->name);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    char path[64];
+    int i;
+
+    g_test_init(&argc, &argv, NULL);
+    g_test_message("host SIMD features: %#x", neon_host_simd_features());
+
+    for (i = 0; i < ARRAY_SIZE(ops3); i++) {
+        snprintf(path, sizeof(path), "/neon-qreg/%s", ops3[i].name);
+        g_test_add_data_func(path, &ops3[i], test_op3);
+    }
+    for (i = 0; i < ARRAY_SIZE(shifts); i++) {
+        snprintf(path, sizeof(path), "/neon-qreg/%s", shifts[i].name);
+        g_test_add_data_func(path, &shifts[i], test_shift);
+    }
+    for (i = 0; i < ARRAY_SIZE(ops2); i++) {
+        snprintf(path, sizeof(path), "/neon-qreg/%s", ops2[i].name);
+        g_test_add_data_func(path, &ops2[i], test_op2);
+    }
+
+    return g_test_run();
+}
@@ -0,0 +1,243 @@
+/*
+ * Page cache unit tests
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+#include <glib.h>
+#include <string.h>
+#include "qemu-common.h"
+
+/* For num_items */
+#include "page_cache.c"
+
+#define PAGE_SIZE 4096
+
+/* A cache of four pages is a single set of four ways */
+#define SET_PAGES 4
+
+static uint8_t page[PAGE_SIZE];
+
+static uint64_t page_addr(int n)
+{
+    return (uint64_t)n * PAGE_SIZE;
+}
+
+static void insert_page(PageCache *cache, int n)
+{
+    memset(page, n, PAGE_SIZE);
+    cache_insert(cache, page_addr(n), page);
+}
+
+static void check_page(PageCache *cache, int n)
+{
+    uint8_t *data = get_cached_data(cache, page_addr(n));
+    int i;
+
+    g_assert(data);
+    for (i = 0; i < PAGE_SIZE; i++) {
+        g_assert_cmpint(data[i], ==, (uint8_t)n);
+    }
+}
+
+static void test_hit_miss(void)
+{
+    PageCache *cache = cache_init(SET_PAGES, PAGE_SIZE);
+
+    g_assert(!cache_is_cached(cache, page_addr(1)));
+    g_assert(get_cached_data(cache, page_addr(1)) == NULL);
+
+    insert_page(cache, 1);
+    g_assert(cache_is_cached(cache, page_addr(1)));
+    check_page(cache, 1);
+    g_assert(!cache_is_cached(cache, page_addr(2)));
+
+    /* Inserting a cached page again replaces its contents */
+    memset(page, 0x55, PAGE_SIZE);
+    cache_insert(cache, page_addr(1), page);
+    g_assert_cmpint(get_cached_data(cache, page_addr(1))[0], ==, 0x55);
+
+    cache_fini(cache);
+    g_free(cache);
+}
+
+static void test_evict_lru(void)
+{
+    PageCache *cache = cache_init(SET_PAGES, PAGE_SIZE);
+    int i;
+
+    for (i = 0; i < SET_PAGES; i++) {
+        insert_page(cache, i);
+    }
+    for (i = 0; i < SET_PAGES; i++) {
+        g_assert(cache_is_cached(cache, page_addr(i)));
+    }
+
+    /* Page 0 is the least recently used one */
+    insert_page(cache, SET_PAGES);
+    g_assert(!cache_is_cached(cache, page_addr(0)));
+    for (i = 1; i <= SET_PAGES; i++) {
+        g_assert(cache_is_cached(cache, page_addr(i)));
+        check_page(cache, i);
+    }
+
+    cache_fini(cache);
+    g_free(cache);
+}
+
+static void test_hit_refreshes_age(void)
+{
+    PageCache *cache = cache_init(SET_PAGES, PAGE_SIZE);
+    int i;
+
+    for (i = 0; i < SET_PAGES; i++) {
+        insert_page(cache, i);
+    }
+
+    /* The hit makes page 0 the most recently used, so page 1 goes */
+    g_assert(cache_is_cached(cache, page_addr(0)));
+    insert_page(cache, SET_PAGES);
+    g_assert(cache_is_cached(cache, page_addr(0)));
+    g_assert(!cache_is_cached(cache, page_addr(1)));
+    check_page(cache, 0);
+
+    /* Rewriting a page refreshes it as well, so page 2 goes next */
+    insert_page(cache, 2);
+    insert_page(cache, SET_PAGES + 1);
+    g_assert(cache_is_cached(cache, page_addr(2)));
+    g_assert(!cache_is_cached(cache, page_addr(3)));
+
+    cache_fini(cache);
+    g_free(cache);
+}
+
+/* The number of cached pages among the first nb_pages, which has to
+   agree with num_items */
+static int count_cached(PageCache *cache, int nb_pages)
+{
+    int i, n = 0;
+
+    for (i = 0; i < nb_pages; i++) {
+        n += get_cached_data(cache, page_addr(i)) != NULL;
+    }
+    g_assert_cmpint(cache->num_items, ==, n);
+    return n;
+}
+
+static void test_num_items(void)
+{
+    PageCache *cache = cache_init(SET_PAGES, PAGE_SIZE);
+    int i;
+
+    g_assert_cmpint(count_cached(cache, 16), ==, 0);
+    for (i = 0; i < SET_PAGES; i++) {
+        insert_page(cache, i);
+        insert_page(cache, i);
+        g_assert_cmpint(count_cached(cache, 16), ==, i + 1);
+    }
+    for (i = SET_PAGES; i < 16; i++) {
+        insert_page(cache, i);
+        g_assert_cmpint(count_cached(cache, 16), ==, SET_PAGES);
+    }
+
+    /* Shrinking to the same number of pages must not lose any */
+    g_assert_cmpint(cache_resize(cache, SET_PAGES), ==, SET_PAGES);
+    g_assert_cmpint(count_cached(cache, 16), ==, SET_PAGES);
+
+    cache_fini(cache);
+    g_free(cache);
+}
+
+static void test_resize_shrink(void)
+{
+    PageCache *cache = cache_init(64, PAGE_SIZE);
+    bool keep[64];
+    int i, n;
+
+    for (i = 0; i < 64; i++) {
+        insert_page(cache, i);
+    }
+    g_assert_cmpint(count_cached(cache, 64), >, SET_PAGES);
+
+    /* Make page 0 the most recently used one */
+    insert_page(cache, 0);
+
+    /* The four most recently used pages that are cached stay: page 0 and
+       the three cached pages that were inserted last */
+    memset(keep, 0, sizeof(keep));
+    keep[0] = true;
+    for (i = 63, n = 1; n < SET_PAGES; i--) {
+        g_assert_cmpint(i, >, 0);
+        if (get_cached_data(cache, page_addr(i))) {
+            keep[i] = true;
+            n++;
+        }
+    }
+
+    g_assert_cmpint(cache_resize(cache, SET_PAGES), ==, SET_PAGES);
+    g_assert_cmpint(count_cached(cache, 64), ==, SET_PAGES);
+    for (i = 0; i < 64; i++) {
+        if (keep[i]) {
+            check_page(cache, i);
+        } else {
+            g_assert(get_cached_data(cache, page_addr(i)) == NULL);
+        }
+    }
+
+    /* The cache still works after the resize */
+    insert_page(cache, 100);
+    check_page(cache, 100);
+    g_assert_cmpint(count_cached(cache, 128), ==, SET_PAGES);
+
+    cache_fini(cache);
+    g_free(cache);
+}
+
+static void test_resize_grow(void)
+{
+    PageCache *cache = cache_init(16, PAGE_SIZE);
+    bool cached[64];
+    int i, n;
+
+    for (i = 0; i < 64; i++) {
+        insert_page(cache, i);
+    }
+    n = 0;
+    for (i = 0; i < 64; i++) {
+        cached[i] = get_cached_data(cache, page_addr(i)) != NULL;
+        n += cached[i];
+    }
+
+    g_assert_cmpint(cache_resize(cache, 1024), ==, 1024);
+    g_assert_cmpint(count_cached(cache, 64), ==, n);
+    for (i = 0; i < 64; i++) {
+        if (cached[i]) {
+            check_page(cache, i);
+        } else {
+            g_assert(get_cached_data(cache, page_addr(i)) == NULL);
+        }
+    }
+
+    /* Now all pages fit */
+    for (i = 0; i < 64; i++) {
+        insert_page(cache, i);
+    }
+    for (i = 0; i < 64; i++) {
+        check_page(cache, i);
+    }
+
+    cache_fini(cache);
+    g_free(cache);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func("/page-cache/hit_miss", test_hit_miss);
+    g_test_add_func("/page-cache/evict_lru", test_evict_lru);
+    g_test_add_func("/page-cache/hit_refreshes_age", test_hit_refreshes_age);
+    g_test_add_func("/page-cache/num_items", test_num_items);
+    g_test_add_func("/page-cache/resize_shrink", test_resize_shrink);
+    g_test_add_func("/page-cache/resize_grow", test_resize_grow);
+    return g_test_run();
+}
@@ -0,0 +1,240 @@
+/*
+ * Bit-exactness tests and micro-benchmark for the VFP host FPU fast path.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+#include <glib.h>
+#include <stdint.h>
+#include <string.h>
+#include "qemu-common.h"
+#include "vfp_hostfp.h"
+
+#define NUM_OPERANDS 100000
+
+typedef struct {
+    const char *name;
+    bool (*host32)(float32, float32, float32 *, float_status *);
+    float32 (*soft32)(float32, float32, float_status *);
+    bool (*host64)(float64, float64, float64 *, float_status *);
+    float64 (*soft64)(float64, float64, float_status *);
+} VFPOp;
+
+static const VFPOp ops[] = {
+    { "add", vfp_hostfp_adds, float32_add, vfp_hostfp_addd, float64_add },
+    { "sub", vfp_hostfp_subs, float32_sub, vfp_hostfp_subd, float64_sub },
+    { "mul", vfp_hostfp_muls, float32_mul, vfp_hostfp_muld, float64_mul },
+    { "div", vfp_hostfp_divs, float32_div, vfp_hostfp_divd, float64_div },
+};
+
+static void init_status(float_status *s, bool fz, bool dn)
+{
+    memset(s, 0, sizeof(*s));
+    /* Same settings as arm_cpu_reset(), inexact already raised */
+    set_float_detect_tininess(float_tininess_before_rounding, s);
+    set_float_rounding_mode(float_round_nearest_even, s);
+    set_flush_to_zero(fz, s);
+    set_flush_inputs_to_zero(fz, s);
+    set_default_nan_mode(dn, s);
+    set_float_exception_flags(float_flag_inexact, s);
+}
+
+/* Random operands, biased towards zeros, denormals, infinities, NaNs and
+   the exponent ranges where overflow and underflow happen.  */
+static uint32_t rand_f32(void)
+{
+    uint32_t sign = (uint32_t)g_test_rand_int_range(0, 2) << 31;
+    uint32_t frac = (uint32_t)g_test_rand_int() & 0x7fffff;
+    uint32_t exp;
+
+    switch (g_test_rand_int_range(0, 8)) {
+    case 0:
+        return sign;
+    case 1:
+        exp = 0;
+        break;
+    case 2:
+        exp = 0xff;
+        break;
+    case 3:
+        exp = g_test_rand_int_range(1, 24);
+        break;
+    case 4:
+        exp = g_test_rand_int_range(0xe8, 0xff);
+        break;
+    default:
+        exp = g_test_rand_int_range(1, 0xff);
+        break;
+    }
+    return sign | (exp << 23) | frac;
+}
+
+static uint64_t rand_f64(void)
+{
+    uint64_t sign = (uint64_t)g_test_rand_int_range(0, 2) << 63;
+    uint64_t frac = (((uint64_t)g_test_rand_int() << 32) |
+                     (uint32_t)g_test_rand_int()) & 0xfffffffffffffULL;
+    uint64_t exp;
+
+    switch (g_test_rand_int_range(0, 8)) {
+    case 0:
+        return sign;
+    case 1:
+        exp = 0;
+        break;
+    case 2:
+        exp = 0x7ff;
+        break;
+    case 3:
+        exp = g_test_rand_int_range(1, 54);
+        break;
+    case 4:
+        exp = g_test_rand_int_range(0x7c0, 0x7ff);
+        break;
+    default:
+        exp = g_test_rand_int_range(1, 0x7ff);
+        break;
+    }
+    return sign | (exp << 52) | frac;
+}
+
+static void check_f32(const VFPOp *op, bool fz, bool dn)
+{
+    float_status soft, host;
+    float32 a, b, rs, rh;
+    int i, hits = 0;
+
+    for (i = 0; i < NUM_OPERANDS; i++) {
+        a = make_float32(rand_f32());
+        b = make_float32(rand_f32());
+        init_status(&soft, fz, dn);
+        init_status(&host, fz, dn);
+        rs = op->soft32(a, b, &soft);
+        if (!op->host32(a, b, &rh, &host)) {
+            continue;
+        }
+        hits++;
+        g_assert_cmphex(float32_val(rh), ==, float32_val(rs));
+        g_assert_cmpint(get_float_exception_flags(&host), ==,
+                        get_float_exception_flags(&soft));
+    }
+    g_assert(!VFP_HOSTFP_ENABLED || hits > 0);
+}
+
+static void check_f64(const VFPOp *op, bool fz, bool dn)
+{
+    float_status soft, host;
+    float64 a, b, rs, rh;
+    int i, hits = 0;
+
+    for (i = 0; i < NUM_OPERANDS; i++) {
+        a = make_float64(rand_f64());
+        b = make_float64(rand_f64());
+        init_status(&soft, fz, dn);
+        init_status(&host, fz, dn);
+        rs = op->soft64(a, b, &soft);
+        if (!op->host64(a, b, &rh, &host)) {
+            continue;
+        }
+        hits++;
+        g_assert_cmphex(float64_val(rh), ==, float64_val(rs));
+        g_assert_cmpint(get_float_exception_flags(&host), ==,
+                        get_float_exception_flags(&soft));
+    }
+    g_assert(!VFP_HOSTFP_ENABLED || hits > 0);
+}
+
+static void test_bitexact(gconstpointer opaque)
+{
+    const VFPOp *op = opaque;
+
+    check_f32(op, false, false);
+    check_f32(op, true, true);
+    check_f64(op, false, false);
+    check_f64(op, true, true);
+}
+
+/* Exact operations must keep using softfloat until inexact is raised */
+static void test_inexact_clear(void)
+{
+    float_status s;
+    float32 r32;
+    float64 r64;
+
+    init_status(&s, false, false);
+    set_float_exception_flags(0, &s);
+    g_assert(!vfp_hostfp_adds(float32_one, float32_one, &r32, &s));
+    g_assert(!vfp_hostfp_muld(float64_one, float64_one, &r64, &s));
+
+    init_status(&s, false, false);
+    set_float_rounding_mode(float_round_to_zero, &s);
+    g_assert(!vfp_hostfp_adds(float32_one, float32_one, &r32, &s));
+}
+
+static void perf_binop(gconstpointer opaque)
+{
+    const VFPOp *op = opaque;
+    static float32 a32[1024], b32[1024];
+    static float64 a64[1024], b64[1024];
+    float_status s;
+    float32 r32 = float32_zero;
+    float64 r64 = float64_zero;
+    double soft_time, host_time;
+    int i, j;
+
+    init_status(&s, false, false);
+    for (i = 0; i < 1024; i++) {
+        a32[i] = make_float32(0x3f800000 | (g_test_rand_int() & 0x7fffff));
+        b32[i] = make_float32(0x40000000 | (g_test_rand_int() & 0x7fffff));
+        a64[i] = float32_to_float64(a32[i], &s);
+        b64[i] = float32_to_float64(b32[i], &s);
+    }
+
+    init_status(&s, false, false);
+    g_test_timer_start();
+    for (j = 0; j < 10000; j++) {
+        for (i = 0; i < 1024; i++) {
+            r32 = op->soft32(a32[i], b32[i], &s);
+            r64 = op->soft64(a64[i], b64[i], &s);
+        }
+    }
+    soft_time = g_test_timer_elapsed();
+
+    init_status(&s, false, false);
+    g_test_timer_start();
+    for (j = 0; j < 10000; j++) {
+        for (i = 0; i < 1024; i++) {
+            if (!op->host32(a32[i], b32[i], &r32, &s)) {
+                r32 = op->soft32(a32[i], b32[i], &s);
+            }
+            if (!op->host64(a64[i], b64[i], &r64, &s)) {
+                r64 = op->soft64(a64[i], b64[i], &s);
+            }
+        }
+    }
+    host_time = g_test_timer_elapsed();
+
+    g_test_message("%s: softfloat %f s, host fpu %f s (%x %" PRIx64 ")",
+                   op->name, soft_time, host_time,
+                   float32_val(r32), float64_val(r64));
+}
+
+int main(int argc, char **argv)
+{
+    char path[64];
+    int i;
+
+    g_test_init(&argc, &argv, NULL);
+    for (i = 0; i < ARRAY_SIZE(ops); i++) {
+        snprintf(path, sizeof(path), "/vfp-hostfp/bitexact/%s", ops[i].name);
+        g_test_add_data_func(path, &ops[i], test_bitexact);
+    }
+    g_test_add_func("/vfp-hostfp/inexact_clear", test_inexact_clear);
+    if (g_test_perf()) {
+        for (i = 0; i < ARRAY_SIZE(ops); i++) {
+            snprintf(path, sizeof(path), "/vfp-hostfp/perf/%s", ops[i].name);
+            g_test_add_data_func(path, &ops[i], perf_binop);
+        }
+    }
+    return g_test_run();
+}
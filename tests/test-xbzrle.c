@@ -179,8 +179,149 @@ static void test_encode_decode(void)
     }
 }
 
+/* Buffers that are not word aligned take the byte at a time path */
+static void test_encode_decode_unaligned(void)
+{
+    uint8_t *buffer = g_malloc0(PAGE_SIZE + 1);
+    uint8_t *test = g_malloc0(PAGE_SIZE + 1);
+    uint8_t *compressed = g_malloc(PAGE_SIZE);
+    int slen = PAGE_SIZE - 3;
+    int dlen = 0, rc = 0;
+
+    test[1 + 100] = 1;
+    test[1 + slen - 1] = 2;
+
+    dlen = xbzrle_encode_buffer(buffer + 1, test + 1, slen, compressed,
+                                PAGE_SIZE);
+    g_assert(dlen > 0);
+
+    rc = xbzrle_decode_buffer(compressed, dlen, buffer + 1, slen);
+    g_assert(rc == slen);
+    g_assert(memcmp(test + 1, buffer + 1, slen) == 0);
+
+    g_free(buffer);
+    g_free(compressed);
+    g_free(test);
+}
+
+static const char *accel_names[XBZRLE_ACCEL_MAX] = {
+    [XBZRLE_ACCEL_LONG] = "long",
+    [XBZRLE_ACCEL_SSE2] = "sse2",
+    [XBZRLE_ACCEL_AVX2] = "avx2",
+};
+
+/* Change random runs of bytes, so that runs start and end at every
+   offset within a vector and some reach the end of the page */
+static void change_runs(uint8_t *buf, int len, int max_run)
+{
+    int i, j, run;
+
+    for (i = g_test_rand_int_range(0, max_run); i < len;
+         i += g_test_rand_int_range(1, max_run)) {
+        run = g_test_rand_int_range(1, max_run);
+        for (j = i; j < i + run && j < len; j++) {
+            buf[j] ^= g_test_rand_int_range(1, 256);
+        }
+        i = j;
+    }
+}
+
+static void test_encode_accel(gconstpointer opaque)
+{
+    XbzrleAccel accel = (uintptr_t)opaque;
+    XbzrleEncodeFunc *encode = xbzrle_encoder(accel);
+    XbzrleEncodeFunc *encode_long = xbzrle_encoder(XBZRLE_ACCEL_LONG);
+    uint8_t *old_buf = g_malloc(PAGE_SIZE);
+    uint8_t *new_buf = g_malloc(PAGE_SIZE);
+    uint8_t *dst = g_malloc(PAGE_SIZE);
+    uint8_t *dst_long = g_malloc(PAGE_SIZE);
+    int i, slen, dlen, rc, rc_long;
+
+    if (!encode) {
+        g_test_message("%s not supported, skipped", accel_names[accel]);
+        goto out;
+    }
+
+    for (i = 0; i < 10000; i++) {
+        slen = PAGE_SIZE - g_test_rand_int_range(0, 16) * sizeof(long);
+        dlen = g_test_rand_bit() ? PAGE_SIZE : g_test_rand_int_range(2, 256);
+        memset(old_buf, i, PAGE_SIZE);
+        memcpy(new_buf, old_buf, PAGE_SIZE);
+        change_runs(new_buf, slen, g_test_rand_int_range(2, 300));
+
+        rc = encode(old_buf, new_buf, slen, dst, dlen);
+        rc_long = encode_long(old_buf, new_buf, slen, dst_long, dlen);
+        g_assert_cmpint(rc, ==, rc_long);
+        if (rc > 0) {
+            g_assert(memcmp(dst, dst_long, rc) == 0);
+        }
+    }
+
+out:
+    g_free(old_buf);
+    g_free(new_buf);
+    g_free(dst);
+    g_free(dst_long);
+}
+
+static void perf_encode(gconstpointer opaque)
+{
+    XbzrleAccel accel = (uintptr_t)opaque;
+    XbzrleEncodeFunc *encode = xbzrle_encoder(accel);
+    uint8_t *old_buf = g_malloc0(PAGE_SIZE);
+    uint8_t *new_buf = g_malloc0(PAGE_SIZE);
+    uint8_t *dst = g_malloc(PAGE_SIZE);
+    double duration;
+    int i, rc = 0;
+
+    if (!encode) {
+        g_test_message("%s not supported, skipped", accel_names[accel]);
+        goto out;
+    }
+
+    /* A few short changes in a mostly unchanged page */
+    change_runs(new_buf, PAGE_SIZE, 200);
+    g_test_timer_start();
+    for (i = 0; i < 1000000; i++) {
+        rc = encode(old_buf, new_buf, PAGE_SIZE, dst, PAGE_SIZE);
+    }
+    duration = g_test_timer_elapsed();
+
+    g_test_message("%s: %f s for 1000000 pages, %.0f MB/s (%d bytes)",
+                   accel_names[accel], duration,
+                   1000000.0 * PAGE_SIZE / duration / 1e6, rc);
+
+out:
+    g_free(old_buf);
+    g_free(new_buf);
+    g_free(dst);
+}
+
+static void perf_zero_page(void)
+{
+    uint8_t *page = qemu_memalign(64, PAGE_SIZE);
+    double duration;
+    size_t offset = 0;
+    int i;
+
+    memset(page, 0, PAGE_SIZE);
+    g_test_timer_start();
+    for (i = 0; i < 1000000; i++) {
+        offset += buffer_find_nonzero_offset(page, PAGE_SIZE);
+    }
+    duration = g_test_timer_elapsed();
+
+    g_test_message("zero page scan: %f s for 1000000 pages, %.0f MB/s",
+                   duration, 1000000.0 * PAGE_SIZE / duration / 1e6);
+    g_assert(offset == 1000000ULL * PAGE_SIZE);
+    qemu_vfree(page);
+}
+
 int main(int argc, char **argv)
 {
+    char path[64];
+    int i;
+
     g_test_init(&argc, &argv, NULL);
     g_test_rand_int();
     g_test_add_func("/xbzrle/uleb", test_uleb);
@@ -191,6 +332,21 @@ int main(int argc, char **argv)
     g_test_add_func("/xbzrle/encode_decode_overflow",
                     test_encode_decode_overflow);
     g_test_add_func("/xbzrle/encode_decode", test_encode_decode);
+    g_test_add_func("/xbzrle/encode_decode_unaligned",
+                    test_encode_decode_unaligned);
+    for (i = XBZRLE_ACCEL_SSE2; i < XBZRLE_ACCEL_MAX; i++) {
+        snprintf(path, sizeof(path), "/xbzrle/encode_accel/%s",
+                 accel_names[i]);
+        g_test_add_data_func(path, (void *)(uintptr_t)i, test_encode_accel);
+    }
+    if (g_test_perf()) {
+        for (i = 0; i < XBZRLE_ACCEL_MAX; i++) {
+            snprintf(path, sizeof(path), "/xbzrle/perf/encode/%s",
+                     accel_names[i]);
+            g_test_add_data_func(path, (void *)(uintptr_t)i, perf_encode);
+        }
+        g_test_add_func("/xbzrle/perf/zero_page", perf_zero_page);
+    }
 
     return g_test_run();
 }
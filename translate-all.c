@@ -59,6 +59,7 @@
 #include "exec/cputlb.h"
 #include "translate-all.h"
 #include "qemu/timer.h"
+#include "fault-injection-profile.h"
 
 //#define DEBUG_TB_INVALIDATE
 //#define DEBUG_FLUSH
@@ -130,6 +131,20 @@ void cpu_gen_init(void)
     tcg_context_init(&tcg_ctx); 
 }
 
+/* return true if the intermediate code generated so far contains a guest
+   memory store */
+static bool tcg_gen_has_stores(TCGContext *s)
+{
+    const uint16_t *opc;
+
+    for (opc = s->gen_opc_buf; opc < s->gen_opc_ptr; opc++) {
+        if (!strncmp(tcg_op_defs[*opc].name, "qemu_st", 7)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /* return non zero if the very first instruction is invalid so that
    the virtual CPU can trigger an exception.
 
@@ -153,6 +168,7 @@ int cpu_gen_code(CPUArchState *env, TranslationBlock *tb, int *gen_code_size_ptr
     tcg_func_start(s);
 
     gen_intermediate_code(env, tb);
+    tb->has_stores = tcg_gen_has_stores(s);
 
     /* generate machine code */
     gen_code_buf = tb->tc_ptr;
@@ -557,6 +573,8 @@ static inline void *alloc_code_gen_buffer(void)
 
 static inline void code_gen_alloc(size_t tb_size)
 {
+    int n;
+
     tcg_ctx.code_gen_buffer_size = size_code_gen_buffer(tb_size);
     tcg_ctx.code_gen_buffer = alloc_code_gen_buffer();
     if (tcg_ctx.code_gen_buffer == NULL) {
@@ -582,6 +600,18 @@ static inline void code_gen_alloc(size_t tb_size)
             CODE_GEN_AVG_BLOCK_SIZE;
     tcg_ctx.tb_ctx.tbs =
             g_malloc(tcg_ctx.code_gen_max_blocks * sizeof(TranslationBlock));
+
+    /* Every region needs the same headroom for a maximum size TB as the
+       whole buffer, so small buffers get fewer regions.  */
+    n = TB_MAX_REGIONS;
+    while (n > 1 && tcg_ctx.code_gen_buffer_size / n <
+           4 * TCG_MAX_OP_SIZE * OPC_BUF_SIZE) {
+        n /= 2;
+    }
+    tcg_ctx.tb_ctx.nb_regions = n;
+    tcg_ctx.tb_ctx.region_size = (tcg_ctx.code_gen_buffer_size / n) &
+                                 ~(size_t)(CODE_GEN_ALIGN - 1);
+    tcg_ctx.tb_ctx.region_max_blocks = tcg_ctx.code_gen_max_blocks / n;
 }
 
 /* Must be called before using the QEMU cpus. 'tb_size' is the size
@@ -606,20 +636,81 @@ bool tcg_enabled(void)
     return tcg_ctx.code_gen_buffer != NULL;
 }
 
-/* Allocate a new translation block. Flush the translation buffer if
-   too many translation blocks or too much generated code. */
+static inline uint8_t *tb_region_start(int r)
+{
+    return tcg_ctx.code_gen_buffer + r * tcg_ctx.tb_ctx.region_size;
+}
+
+/* Return true if the current region has no room for another TB.  */
+static bool tb_region_full(void)
+{
+    TBContext *ctx = &tcg_ctx.tb_ctx;
+    int r = ctx->region;
+    uint8_t *end;
+
+    if (r == ctx->nb_regions - 1) {
+        end = tcg_ctx.code_gen_buffer + tcg_ctx.code_gen_buffer_max_size;
+    } else {
+        end = tb_region_start(r + 1) - TCG_MAX_OP_SIZE * OPC_BUF_SIZE;
+    }
+    return ctx->region_nb_tbs[r] >= ctx->region_max_blocks ||
+           tcg_ctx.code_gen_ptr >= end;
+}
+
+/* Continue in the next region, invalidating the TBs that it still holds
+   from the previous round.  Jumps from other regions into them are reset
+   by tb_phys_invalidate().  */
+static void tb_region_evict(void)
+{
+    TBContext *ctx = &tcg_ctx.tb_ctx;
+    TranslationBlock *tb;
+    int r, i;
+
+    ctx->region_code[ctx->region] = tcg_ctx.code_gen_ptr -
+                                    tb_region_start(ctx->region);
+    r = (ctx->region + 1) % ctx->nb_regions;
+    if (ctx->region_nb_tbs[r]) {
+        for (i = 0; i < ctx->region_nb_tbs[r]; i++) {
+            tb = &ctx->tbs[r * ctx->region_max_blocks + i];
+            if (!(tb->cflags & CF_INVALID)) {
+                tb_phys_invalidate(tb, -1);
+                ctx->tb_phys_invalidate_count--;
+            }
+        }
+        ctx->nb_tbs -= ctx->region_nb_tbs[r];
+        ctx->region_evict_tbs += ctx->region_nb_tbs[r];
+        ctx->region_evict_count++;
+        ctx->region_nb_tbs[r] = 0;
+    }
+    ctx->region_code[r] = 0;
+    ctx->region = r;
+    tcg_ctx.code_gen_ptr = tb_region_start(r);
+}
+
+/* Allocate a new translation block.  If the current region is full,
+   move on to the next one.  Return NULL if the whole translation buffer
+   must be flushed, i.e. if it is not split into regions.  */
 static TranslationBlock *tb_alloc(target_ulong pc)
 {
+    TBContext *ctx = &tcg_ctx.tb_ctx;
     TranslationBlock *tb;
 
-    if (tcg_ctx.tb_ctx.nb_tbs >= tcg_ctx.code_gen_max_blocks ||
-        (tcg_ctx.code_gen_ptr - tcg_ctx.code_gen_buffer) >=
-         tcg_ctx.code_gen_buffer_max_size) {
-        return NULL;
+    if (tb_region_full()) {
+        if (ctx->nb_regions == 1) {
+            return NULL;
+        }
+        tb_region_evict();
     }
-    tb = &tcg_ctx.tb_ctx.tbs[tcg_ctx.tb_ctx.nb_tbs++];
+    tb = &ctx->tbs[ctx->region * ctx->region_max_blocks +
+                   ctx->region_nb_tbs[ctx->region]++];
+    ctx->nb_tbs++;
     tb->pc = pc;
     tb->cflags = 0;
+    tb->exec_count = 0;
+    tb->taken_count = 0;
+    tb->succ_pc[0] = -1;
+    tb->succ_pc[1] = -1;
+    tb->regs_accessed = 0;
     return tb;
 }
 
@@ -628,10 +719,15 @@ void tb_free(TranslationBlock *tb)
     /* In practice this is mostly used for single use temporary TB
        Ignore the hard cases and just back up if this TB happens to
        be the last one generated.  */
-    if (tcg_ctx.tb_ctx.nb_tbs > 0 &&
-            tb == &tcg_ctx.tb_ctx.tbs[tcg_ctx.tb_ctx.nb_tbs - 1]) {
+    TBContext *ctx = &tcg_ctx.tb_ctx;
+    int r = ctx->region;
+
+    if (ctx->region_nb_tbs[r] > 0 &&
+            tb == &ctx->tbs[r * ctx->region_max_blocks +
+                            ctx->region_nb_tbs[r] - 1]) {
         tcg_ctx.code_gen_ptr = tb->tc_ptr;
-        tcg_ctx.tb_ctx.nb_tbs--;
+        ctx->region_nb_tbs[r]--;
+        ctx->nb_tbs--;
     }
 }
 
@@ -695,6 +791,10 @@ void tb_flush(CPUArchState *env1)
         cpu_abort(env1, "Internal error: code buffer overflow\n");
     }
     tcg_ctx.tb_ctx.nb_tbs = 0;
+    tcg_ctx.tb_ctx.region = 0;
+    memset(tcg_ctx.tb_ctx.region_nb_tbs, 0,
+           sizeof(tcg_ctx.tb_ctx.region_nb_tbs));
+    memset(tcg_ctx.tb_ctx.region_code, 0, sizeof(tcg_ctx.tb_ctx.region_code));
 
     CPU_FOREACH(cpu) {
         CPUArchState *env = cpu->env_ptr;
@@ -876,10 +976,30 @@ void tb_phys_invalidate(TranslationBlock *tb, tb_page_addr_t page_addr)
         tb1 = tb2;
     }
     tb->jmp_first = (TranslationBlock *)((uintptr_t)tb | 2); /* fail safe */
+    tb->cflags |= CF_INVALID;
 
     tcg_ctx.tb_ctx.tb_phys_invalidate_count++;
 }
 
+/* Invalidate the TBs that read or write one of the guest registers in
+   'regs', e.g. because the registers with fault injection hooks have
+   changed.  All other TBs are kept.  */
+void tb_invalidate_regs(uint32_t regs)
+{
+    TBContext *ctx = &tcg_ctx.tb_ctx;
+    TranslationBlock *tb;
+    int r, i;
+
+    for (r = 0; r < ctx->nb_regions; r++) {
+        for (i = 0; i < ctx->region_nb_tbs[r]; i++) {
+            tb = &ctx->tbs[r * ctx->region_max_blocks + i];
+            if (!(tb->cflags & CF_INVALID) && (tb->regs_accessed & regs)) {
+                tb_phys_invalidate(tb, -1);
+            }
+        }
+    }
+}
+
 static inline void set_bits(uint8_t *tab, int start, int len)
 {
     int end, mask, end1;
@@ -936,6 +1056,115 @@ static void build_page_bitmap(PageDesc *p)
     }
 }
 
+#if !defined(CONFIG_USER_ONLY)
+/* -tb-prefetch: the direct successors of new TBs are queued, and while
+   the CPUs are halted, cpus.c translates them with tb_prefetch() so that
+   the code is ready when it is reached.  The queue is a ring of
+   tb_prefetch_size entries; the newest entries are translated first and
+   overwrite the oldest ones.  */
+typedef struct TBPrefetch {
+    target_ulong pc;
+    target_ulong cs_base;
+    uint64_t flags;
+} TBPrefetch;
+
+static TBPrefetch *tb_prefetch_queue;
+static int tb_prefetch_head;
+static int tb_prefetch_count;
+
+static void tb_prefetch_push(TranslationBlock *tb)
+{
+    TBPrefetch *e;
+    int n;
+
+    if (!tb_prefetch_queue) {
+        tb_prefetch_queue = g_new(TBPrefetch, tb_prefetch_size);
+    }
+    for (n = 0; n < 2; n++) {
+        if (tb->succ_pc[n] == -1) {
+            continue;
+        }
+        e = &tb_prefetch_queue[(tb_prefetch_head + tb_prefetch_count) %
+                               tb_prefetch_size];
+        e->pc = tb->succ_pc[n];
+        e->cs_base = tb->cs_base;
+        e->flags = tb->flags;
+        if (tb_prefetch_count < tb_prefetch_size) {
+            tb_prefetch_count++;
+        } else {
+            tb_prefetch_head = (tb_prefetch_head + 1) % tb_prefetch_size;
+        }
+    }
+}
+
+/* Code can only be fetched outside cpu_exec() if that cannot fault, i.e.
+   if the page is in the code TLB.  */
+static bool tb_prefetch_mapped(CPUArchState *env, target_ulong addr)
+{
+    int mmu_idx = cpu_mmu_index(env);
+    int index = (addr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
+
+    return env->tlb_table[mmu_idx][index].addr_code ==
+           (addr & TARGET_PAGE_MASK);
+}
+
+static bool tb_prefetch_exists(target_ulong pc, tb_page_addr_t phys_pc,
+                               const TBPrefetch *e)
+{
+    TranslationBlock *tb;
+
+    tb = tcg_ctx.tb_ctx.tb_phys_hash[tb_phys_hash_func(phys_pc)];
+    for (; tb; tb = tb->phys_hash_next) {
+        if (tb->pc == pc && tb->page_addr[0] == (phys_pc & TARGET_PAGE_MASK)
+            && tb->cs_base == e->cs_base && tb->flags == e->flags) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Translate the next queued block that is not translated yet.  Returns
+   false if there is none, or if the current region of the code buffer is
+   half full: the rest is kept for code that is actually executed, and no
+   code is ever evicted to translate ahead.  */
+bool tb_prefetch(CPUArchState *env)
+{
+    TBContext *ctx = &tcg_ctx.tb_ctx;
+    TBPrefetch *e;
+    TranslationBlock *tb;
+    tb_page_addr_t phys_pc;
+
+    while (tb_prefetch_count) {
+        if (ctx->region_nb_tbs[ctx->region] >= ctx->region_max_blocks / 2 ||
+            tcg_ctx.code_gen_ptr - tb_region_start(ctx->region) >=
+            ctx->region_size / 2) {
+            return false;
+        }
+        tb_prefetch_count--;
+        e = &tb_prefetch_queue[(tb_prefetch_head + tb_prefetch_count) %
+                               tb_prefetch_size];
+        /* A block may extend into the next page */
+        if (!tb_prefetch_mapped(env, e->pc) ||
+            !tb_prefetch_mapped(env, (e->pc & TARGET_PAGE_MASK) +
+                                     TARGET_PAGE_SIZE)) {
+            continue;
+        }
+        phys_pc = get_page_addr_code(env, e->pc);
+        if (tb_prefetch_exists(e->pc, phys_pc, e)) {
+            continue;
+        }
+        spin_lock(&tcg_ctx.tb_ctx.tb_lock);
+        tb = tb_gen_code(env, e->pc, e->cs_base, e->flags, 0);
+        /* tb_find_slow() counts the first lookup as a hit */
+        tb->cflags |= CF_PREFETCHED;
+        spin_unlock(&tcg_ctx.tb_ctx.tb_lock);
+        ctx->tb_prefetch_count++;
+        return true;
+    }
+    return false;
+}
+#endif
+
 TranslationBlock *tb_gen_code(CPUArchState *env,
                               target_ulong pc, target_ulong cs_base,
                               int flags, int cflags)
@@ -945,6 +1174,7 @@ TranslationBlock *tb_gen_code(CPUArchState *env,
     tb_page_addr_t phys_pc, phys_page2;
     target_ulong virt_page2;
     int code_gen_size;
+    FiesProfileScope profile_scope;
 
     phys_pc = get_page_addr_code(env, pc);
     tb = tb_alloc(pc);
@@ -961,7 +1191,9 @@ TranslationBlock *tb_gen_code(CPUArchState *env,
     tb->cs_base = cs_base;
     tb->flags = flags;
     tb->cflags = cflags;
+    fies_profile_start(&profile_scope);
     cpu_gen_code(env, tb, &code_gen_size);
+    fies_profile_end(&profile_scope, FIES_PROF_TRANSLATION);
     tcg_ctx.code_gen_ptr = (void *)(((uintptr_t)tcg_ctx.code_gen_ptr +
             code_gen_size + CODE_GEN_ALIGN - 1) & ~(CODE_GEN_ALIGN - 1));
 
@@ -972,6 +1204,11 @@ TranslationBlock *tb_gen_code(CPUArchState *env,
         phys_page2 = get_page_addr_code(env, virt_page2);
     }
     tb_link_page(tb, phys_pc, phys_page2);
+#if !defined(CONFIG_USER_ONLY)
+    if (tb_prefetch_size) {
+        tb_prefetch_push(tb);
+    }
+#endif
     return tb;
 }
 
@@ -1322,23 +1559,31 @@ static void tb_link_page(TranslationBlock *tb, tb_page_addr_t phys_pc,
    tb[1].tc_ptr. Return NULL if not found */
 static TranslationBlock *tb_find_pc(uintptr_t tc_ptr)
 {
-    int m_min, m_max, m;
+    TBContext *ctx = &tcg_ctx.tb_ctx;
+    int m_min, m_max, m, r;
     uintptr_t v;
-    TranslationBlock *tb;
+    TranslationBlock *tb, *tbs;
 
-    if (tcg_ctx.tb_ctx.nb_tbs <= 0) {
+    if (tc_ptr < (uintptr_t)tcg_ctx.code_gen_buffer) {
         return NULL;
     }
-    if (tc_ptr < (uintptr_t)tcg_ctx.code_gen_buffer ||
-        tc_ptr >= (uintptr_t)tcg_ctx.code_gen_ptr) {
+    r = (tc_ptr - (uintptr_t)tcg_ctx.code_gen_buffer) / ctx->region_size;
+    if (r >= ctx->nb_regions) {
+        r = ctx->nb_regions - 1;
+    }
+    if (ctx->region_nb_tbs[r] <= 0) {
         return NULL;
     }
+    if (r == ctx->region && tc_ptr >= (uintptr_t)tcg_ctx.code_gen_ptr) {
+        return NULL;
+    }
+    tbs = &ctx->tbs[r * ctx->region_max_blocks];
     /* binary search (cf Knuth) */
     m_min = 0;
-    m_max = tcg_ctx.tb_ctx.nb_tbs - 1;
+    m_max = ctx->region_nb_tbs[r] - 1;
     while (m_min <= m_max) {
         m = (m_min + m_max) >> 1;
-        tb = &tcg_ctx.tb_ctx.tbs[m];
+        tb = &tbs[m];
         v = (uintptr_t)tb->tc_ptr;
         if (v == tc_ptr) {
             return tb;
@@ -1348,7 +1593,46 @@ static TranslationBlock *tb_find_pc(uintptr_t tc_ptr)
             m_min = m + 1;
         }
     }
-    return &tcg_ctx.tb_ctx.tbs[m_max];
+    return &tbs[m_max];
+}
+
+static bool tb_store_free_loop(TranslationBlock *head, TranslationBlock *tb,
+                               int max_tbs)
+{
+    TranslationBlock *tb1;
+    unsigned int n1;
+
+    if (tb->has_stores) {
+        return false;
+    }
+    /* walk the list of TBs jumping to 'tb' */
+    tb1 = tb->jmp_first;
+    for (;;) {
+        n1 = (uintptr_t)tb1 & 3;
+        if (n1 == 2) {
+            break;
+        }
+        tb1 = (TranslationBlock *)((uintptr_t)tb1 & ~3);
+        if (tb1 == head) {
+            return true;
+        }
+        if (max_tbs > 1 && tb_store_free_loop(head, tb1, max_tbs - 1)) {
+            return true;
+        }
+        tb1 = tb1->jmp_next[n1];
+    }
+    return false;
+}
+
+/* Return true if the TB containing the host code address 'tc_ptr' is part
+   of a cycle of at most 'max_tbs' directly chained TBs, none of which
+   stores to guest memory.  Only patched jumps are followed, so a loop is
+   recognized once it has gone round at least twice.  */
+bool tb_is_store_free_loop(uintptr_t tc_ptr, int max_tbs)
+{
+    TranslationBlock *tb = tb_find_pc(tc_ptr);
+
+    return tb && tb_store_free_loop(tb, tb, max_tbs);
 }
 
 #if defined(TARGET_HAS_ICE) && !defined(CONFIG_USER_ONLY)
@@ -1491,8 +1775,10 @@ void tb_flush_jmp_cache(CPUArchState *env, target_ulong addr)
 
 void dump_exec_info(FILE *f, fprintf_function cpu_fprintf)
 {
-    int i, target_code_size, max_target_code_size;
+    TBContext *ctx = &tcg_ctx.tb_ctx;
+    int i, r, target_code_size, max_target_code_size;
     int direct_jmp_count, direct_jmp2_count, cross_page;
+    size_t code_size;
     TranslationBlock *tb;
 
     target_code_size = 0;
@@ -1500,8 +1786,18 @@ void dump_exec_info(FILE *f, fprintf_function cpu_fprintf)
     cross_page = 0;
     direct_jmp_count = 0;
     direct_jmp2_count = 0;
-    for (i = 0; i < tcg_ctx.tb_ctx.nb_tbs; i++) {
-        tb = &tcg_ctx.tb_ctx.tbs[i];
+    code_size = 0;
+    for (i = 0; i < ctx->nb_regions * ctx->region_max_blocks; i++) {
+        r = i / ctx->region_max_blocks;
+        if (i % ctx->region_max_blocks == 0) {
+            code_size += r == ctx->region ?
+                         tcg_ctx.code_gen_ptr - tb_region_start(r) :
+                         ctx->region_code[r];
+        }
+        if (i % ctx->region_max_blocks >= ctx->region_nb_tbs[r]) {
+            continue;
+        }
+        tb = &ctx->tbs[i];
         target_code_size += tb->size;
         if (tb->size > max_target_code_size) {
             max_target_code_size = tb->size;
@@ -1518,22 +1814,19 @@ void dump_exec_info(FILE *f, fprintf_function cpu_fprintf)
     }
     /* XXX: avoid using doubles ? */
     cpu_fprintf(f, "Translation buffer state:\n");
-    cpu_fprintf(f, "gen code size       %td/%zd\n",
-                tcg_ctx.code_gen_ptr - tcg_ctx.code_gen_buffer,
-                tcg_ctx.code_gen_buffer_max_size);
+    cpu_fprintf(f, "gen code size       %zd/%zd\n",
+                code_size, tcg_ctx.code_gen_buffer_max_size);
+    cpu_fprintf(f, "TB regions          %d (filling %d)\n",
+                ctx->nb_regions, ctx->region);
     cpu_fprintf(f, "TB count            %d/%d\n",
             tcg_ctx.tb_ctx.nb_tbs, tcg_ctx.code_gen_max_blocks);
     cpu_fprintf(f, "TB avg target size  %d max=%d bytes\n",
             tcg_ctx.tb_ctx.nb_tbs ? target_code_size /
                     tcg_ctx.tb_ctx.nb_tbs : 0,
             max_target_code_size);
-    cpu_fprintf(f, "TB avg host size    %td bytes (expansion ratio: %0.1f)\n",
-            tcg_ctx.tb_ctx.nb_tbs ? (tcg_ctx.code_gen_ptr -
-                                     tcg_ctx.code_gen_buffer) /
-                                     tcg_ctx.tb_ctx.nb_tbs : 0,
-                target_code_size ? (double) (tcg_ctx.code_gen_ptr -
-                                             tcg_ctx.code_gen_buffer) /
-                                             target_code_size : 0);
+    cpu_fprintf(f, "TB avg host size    %zd bytes (expansion ratio: %0.1f)\n",
+            tcg_ctx.tb_ctx.nb_tbs ? code_size / tcg_ctx.tb_ctx.nb_tbs : 0,
+            target_code_size ? (double) code_size / target_code_size : 0);
     cpu_fprintf(f, "cross page TB count %d (%d%%)\n", cross_page,
             tcg_ctx.tb_ctx.nb_tbs ? (cross_page * 100) /
                                     tcg_ctx.tb_ctx.nb_tbs : 0);
@@ -1546,9 +1839,13 @@ void dump_exec_info(FILE *f, fprintf_function cpu_fprintf)
                         tcg_ctx.tb_ctx.nb_tbs : 0);
     cpu_fprintf(f, "\nStatistics:\n");
     cpu_fprintf(f, "TB flush count      %d\n", tcg_ctx.tb_ctx.tb_flush_count);
+    cpu_fprintf(f, "region evict count  %d (%d TBs)\n",
+                ctx->region_evict_count, ctx->region_evict_tbs);
     cpu_fprintf(f, "TB invalidate count %d\n",
             tcg_ctx.tb_ctx.tb_phys_invalidate_count);
     cpu_fprintf(f, "TLB flush count     %d\n", tlb_flush_count);
+    cpu_fprintf(f, "TB prefetch count   %d (%d hit)\n",
+                ctx->tb_prefetch_count, ctx->tb_prefetch_hit_count);
     tcg_dump_info(f, cpu_fprintf);
 }
 
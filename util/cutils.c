@@ -27,6 +27,9 @@
 
 #include "qemu/sockets.h"
 #include "qemu/iov.h"
+#ifdef CONFIG_AVX2_OPT
+#include <immintrin.h>
+#endif
 
 void strpadcpy(char *buf, int buf_size, const char *str, char pad)
 {
@@ -163,6 +166,52 @@ int qemu_fdatasync(int fd)
 #endif
 }
 
+#ifdef CONFIG_AVX2_OPT
+static bool buffer_find_nonzero_avx2;
+
+static void __attribute__((constructor)) init_buffer_find_nonzero(void)
+{
+    /* constructors may run before the one that initializes the CPU model */
+    __builtin_cpu_init();
+    buffer_find_nonzero_avx2 = __builtin_cpu_supports("avx2");
+}
+
+/* Same as below with 32 byte vectors, buf must be 32 byte aligned and len
+ * a multiple of BUFFER_FIND_NONZERO_OFFSET_UNROLL_FACTOR * 32.
+ */
+static size_t __attribute__((target("avx2")))
+buffer_find_nonzero_offset_avx2(const void *buf, size_t len)
+{
+    const __m256i *p = buf;
+    __m256i tmp;
+    size_t i;
+
+    for (i = 0; i < BUFFER_FIND_NONZERO_OFFSET_UNROLL_FACTOR; i++) {
+        if (!_mm256_testz_si256(p[i], p[i])) {
+            return i * sizeof(__m256i);
+        }
+    }
+
+    for (i = BUFFER_FIND_NONZERO_OFFSET_UNROLL_FACTOR;
+         i < len / sizeof(__m256i);
+         i += BUFFER_FIND_NONZERO_OFFSET_UNROLL_FACTOR) {
+        tmp = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(p[i + 0],
+                                                               p[i + 1]),
+                                              _mm256_or_si256(p[i + 2],
+                                                              p[i + 3])),
+                              _mm256_or_si256(_mm256_or_si256(p[i + 4],
+                                                              p[i + 5]),
+                                              _mm256_or_si256(p[i + 6],
+                                                              p[i + 7])));
+        if (!_mm256_testz_si256(tmp, tmp)) {
+            break;
+        }
+    }
+
+    return i * sizeof(__m256i);
+}
+#endif
+
 /*
  * Searches for an area with non-zero content in a buffer
  *
@@ -178,7 +227,8 @@ int qemu_fdatasync(int fd)
  * down to a multiple of sizeof(VECTYPE) for the first
  * BUFFER_FIND_NONZERO_OFFSET_UNROLL_FACTOR chunks and down to
  * BUFFER_FIND_NONZERO_OFFSET_UNROLL_FACTOR * sizeof(VECTYPE)
- * afterwards.
+ * afterwards.  On hosts with AVX2 the vector size is 32 bytes whenever
+ * buf and len allow it.
  *
  * If the buffer is all zero the return value is equal to len.
  */
@@ -195,6 +245,14 @@ size_t buffer_find_nonzero_offset(const void *buf, size_t len)
         return 0;
     }
 
+#ifdef CONFIG_AVX2_OPT
+    if (buffer_find_nonzero_avx2 &&
+        len % (BUFFER_FIND_NONZERO_OFFSET_UNROLL_FACTOR * 32) == 0 &&
+        ((uintptr_t) buf) % 32 == 0) {
+        return buffer_find_nonzero_offset_avx2(buf, len);
+    }
+#endif
+
     for (i = 0; i < BUFFER_FIND_NONZERO_OFFSET_UNROLL_FACTOR; i++) {
         if (!ALL_EQ(p[i], zero)) {
             return i * sizeof(VECTYPE);
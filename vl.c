@@ -173,7 +173,10 @@ int main(int argc, char **argv)
 #include "fault-injection-collector.h"
 //#include "fault-injection-controller.h"
 #include "fault-injection-config.h"
-//#include "profiler.h"
+#include "fault-injection-profile.h"
+#include "fault-injection-campaign.h"
+#include "fault-injection-journal.h"
+#include "profiler.h"
 
 //#define DEBUG_NET
 //#define DEBUG_SLIRP
@@ -192,6 +195,7 @@ static int display_remote;
 const char* keyboard_layout = NULL;
 ram_addr_t ram_size;
 const char *mem_path = NULL;
+const char *mem_golden = NULL;
 #ifdef MAP_POPULATE
 int mem_prealloc = 0; /* force preallocation of physical target memory */
 #endif
@@ -211,6 +215,10 @@ CharDriverState *virtcon_hds[MAX_VIRTIO_CONSOLES];
 CharDriverState *sclp_hds[MAX_SCLP_CONSOLES];
 int win2k_install_hack = 0;
 int singlestep = 0;
+int busy_wait_warp = 0;
+int superblock_threshold = 0;
+int tb_prefetch_size = 0;
+int savevm_threads = 0;
 int smp_cpus = 1;
 int max_cpus = 0;
 int smp_cores = 1;
@@ -229,6 +237,7 @@ const char *watchdog;
 QEMUOptionRom option_rom[MAX_OPTION_ROMS];
 int nb_option_roms;
 int semihosting_enabled = 0;
+const char *semihosting_console = NULL;
 int old_param = 0;
 const char *qemu_name;
 int alt_grab = 0;
@@ -246,6 +255,7 @@ unsigned int profile_ram_addresses = 0;
 unsigned int profile_pc_status = 0;
 unsigned int profile_registers = 0;
 unsigned int profile_condition_flags = 0;
+unsigned int profile_instructions = 0;
 
 
 typedef struct FWBootEntry FWBootEntry;
@@ -610,6 +620,7 @@ typedef struct {
 static const RunStateTransition runstate_transitions_def[] = {
     /*     from      ->     to      */
     { RUN_STATE_DEBUG, RUN_STATE_RUNNING },
+    { RUN_STATE_DEBUG, RUN_STATE_INTERNAL_ERROR },
 
     { RUN_STATE_INMIGRATE, RUN_STATE_RUNNING },
     { RUN_STATE_INMIGRATE, RUN_STATE_PAUSED },
@@ -622,6 +633,7 @@ static const RunStateTransition runstate_transitions_def[] = {
 
     { RUN_STATE_PAUSED, RUN_STATE_RUNNING },
     { RUN_STATE_PAUSED, RUN_STATE_FINISH_MIGRATE },
+    { RUN_STATE_PAUSED, RUN_STATE_INTERNAL_ERROR },
 
     { RUN_STATE_POSTMIGRATE, RUN_STATE_RUNNING },
     { RUN_STATE_POSTMIGRATE, RUN_STATE_FINISH_MIGRATE },
@@ -629,11 +641,13 @@ static const RunStateTransition runstate_transitions_def[] = {
     { RUN_STATE_PRELAUNCH, RUN_STATE_RUNNING },
     { RUN_STATE_PRELAUNCH, RUN_STATE_FINISH_MIGRATE },
     { RUN_STATE_PRELAUNCH, RUN_STATE_INMIGRATE },
+    { RUN_STATE_PRELAUNCH, RUN_STATE_INTERNAL_ERROR },
 
     { RUN_STATE_FINISH_MIGRATE, RUN_STATE_RUNNING },
     { RUN_STATE_FINISH_MIGRATE, RUN_STATE_POSTMIGRATE },
 
     { RUN_STATE_RESTORE_VM, RUN_STATE_RUNNING },
+    { RUN_STATE_RESTORE_VM, RUN_STATE_INTERNAL_ERROR },
 
     { RUN_STATE_RUNNING, RUN_STATE_DEBUG },
     { RUN_STATE_RUNNING, RUN_STATE_INTERNAL_ERROR },
@@ -2862,6 +2876,7 @@ int main(int argc, char **argv, char **envp)
     int optind;
     const char *optarg;
     const char *loadvm = NULL;
+    bool fi_journal = false;
     QEMUMachine *machine;
     const char *cpu_model;
     const char *vga_model = "none";
@@ -3238,6 +3253,9 @@ int main(int argc, char **argv, char **envp)
             case QEMU_OPTION_mempath:
                 mem_path = optarg;
                 break;
+            case QEMU_OPTION_mem_golden:
+                mem_golden = optarg;
+                break;
 #ifdef MAP_POPULATE
             case QEMU_OPTION_mem_prealloc:
                 mem_prealloc = 1;
@@ -3476,6 +3494,14 @@ int main(int argc, char **argv, char **envp)
         case QEMU_OPTION_loadvm:
         loadvm = optarg;
         break;
+            case QEMU_OPTION_savevm_threads:
+                savevm_threads = strtol(optarg, NULL, 0);
+                if (savevm_threads < 1 || savevm_threads > 64) {
+                    fprintf(stderr, "Invalid number of savevm threads: %s\n",
+                            optarg);
+                    exit(1);
+                }
+                break;
             case QEMU_OPTION_full_screen:
                 full_screen = 1;
                 break;
@@ -3601,6 +3627,11 @@ int main(int argc, char **argv, char **envp)
                         case 'p':
                             profile_pc_status = 1;
                             break;
+                        case 'i':
+                            if (!profile_instructions)
+                                atexit(profiler_report_instructions);
+                            profile_instructions = 1;
+                            break;
                         default:
                             break;
                     }
@@ -3657,6 +3688,12 @@ int main(int argc, char **argv, char **envp)
 
                 free(opt_str);
                 break;
+            case QEMU_OPTION_fi_campaign:
+                fies_campaign_parse_option(optarg);
+                break;
+            case QEMU_OPTION_fi_journal:
+                fi_journal = true;
+                break;
             case QEMU_OPTION_usbdevice:
                 olist = qemu_find_opts("machine");
                 qemu_opts_parse(olist, "usb=on", 0);
@@ -3731,6 +3768,9 @@ int main(int argc, char **argv, char **envp)
             case QEMU_OPTION_semihosting:
                 semihosting_enabled = 1;
                 break;
+            case QEMU_OPTION_semihosting_console:
+                semihosting_console = optarg;
+                break;
             case QEMU_OPTION_tdf:
                 fprintf(stderr, "Warning: user space PIT time drift fix "
                                 "is no longer supported.\n");
@@ -3785,6 +3825,25 @@ int main(int argc, char **argv, char **envp)
             case QEMU_OPTION_icount:
                 icount_option = optarg;
                 break;
+            case QEMU_OPTION_warp_busy_wait:
+                busy_wait_warp = 1;
+                break;
+            case QEMU_OPTION_tb_prefetch:
+                tb_prefetch_size = strtol(optarg, NULL, 0);
+                if (tb_prefetch_size < 0) {
+                    fprintf(stderr, "Invalid TB prefetch queue size: %s\n",
+                            optarg);
+                    exit(1);
+                }
+                break;
+            case QEMU_OPTION_superblocks:
+                superblock_threshold = strtol(optarg, NULL, 0);
+                if (superblock_threshold < 0) {
+                    fprintf(stderr, "Invalid superblock threshold: %s\n",
+                            optarg);
+                    exit(1);
+                }
+                break;
             case QEMU_OPTION_incoming:
                 incoming = optarg;
                 runstate_set(RUN_STATE_INMIGRATE);
@@ -4228,6 +4287,10 @@ int main(int argc, char **argv, char **envp)
         fprintf(stderr, "-icount is not allowed with kvm or xen\n");
         exit(1);
     }
+    if (icount_option && superblock_threshold) {
+        fprintf(stderr, "-superblocks is not allowed with -icount\n");
+        exit(1);
+    }
     configure_icount(icount_option);
 
     /* clean up network at qemu process termination */
@@ -4362,6 +4425,8 @@ int main(int argc, char **argv, char **envp)
                                  .kernel_cmdline = kernel_cmdline,
                                  .initrd_filename = initrd_filename,
                                  .cpu_model = cpu_model };
+    /* Set before init, the -mem-golden images depend on the machine type */
+    current_machine = machine;
     machine->init(&args);
 
     audio_init();
@@ -4370,8 +4435,6 @@ int main(int argc, char **argv, char **envp)
 
     set_numa_modes();
 
-    current_machine = machine;
-
     /* init USB devices */
     if (usb_enabled(false)) {
         if (foreach_device_config(DEV_USB, usb_parse) < 0)
@@ -4461,11 +4524,15 @@ int main(int argc, char **argv, char **envp)
     rom_load_done();
 
     qemu_system_reset(VMRESET_SILENT);
+    qemu_ram_save_golden();
     if (loadvm) {
         if (load_vmstate(loadvm) < 0) {
             autostart = 0;
         }
     }
+    if (fi_journal) {
+        fies_journal_start();
+    }
 
     if (incoming) {
         Error *local_err = NULL;
@@ -4482,6 +4549,7 @@ int main(int argc, char **argv, char **envp)
 
     os_setup_post();
 
+    fies_profile_init();
     main_loop();
     bdrv_close_all();
     pause_all_vcpus();
@@ -11,7 +11,11 @@
  *
  */
 #include "qemu-common.h"
+#include "qemu/host-utils.h"
 #include "include/migration/migration.h"
+#ifdef CONFIG_AVX2_OPT
+#include <immintrin.h>
+#endif
 
 /*
   page = zrun nzrun
@@ -23,16 +27,16 @@
 
   length = uleb128 encoded integer
  */
-int xbzrle_encode_buffer(uint8_t *old_buf, uint8_t *new_buf, int slen,
-                         uint8_t *dst, int dlen)
+static int xbzrle_encode_buffer_long(uint8_t *old_buf, uint8_t *new_buf,
+                                     int slen, uint8_t *dst, int dlen)
 {
     uint32_t zrun_len = 0, nzrun_len = 0;
     int d = 0, i = 0;
     long res, xor;
     uint8_t *nzrun_start = NULL;
-
-    g_assert(!(((uintptr_t)old_buf | (uintptr_t)new_buf | slen) %
-               sizeof(long)));
+    /* unaligned buffers are compared a byte at a time */
+    bool words = !(((uintptr_t)old_buf | (uintptr_t)new_buf | slen) %
+                   sizeof(long));
 
     while (i < slen) {
         /* overflow */
@@ -41,7 +45,7 @@ int xbzrle_encode_buffer(uint8_t *old_buf, uint8_t *new_buf, int slen,
         }
 
         /* not aligned to sizeof(long) */
-        res = (slen - i) % sizeof(long);
+        res = words ? (slen - i) % sizeof(long) : slen - i;
         while (res && old_buf[i] == new_buf[i]) {
             zrun_len++;
             i++;
@@ -83,7 +87,7 @@ int xbzrle_encode_buffer(uint8_t *old_buf, uint8_t *new_buf, int slen,
             return -1;
         }
         /* not aligned to sizeof(long) */
-        res = (slen - i) % sizeof(long);
+        res = words ? (slen - i) % sizeof(long) : slen - i;
         while (res && old_buf[i] != new_buf[i]) {
             i++;
             nzrun_len++;
@@ -123,6 +127,197 @@ int xbzrle_encode_buffer(uint8_t *old_buf, uint8_t *new_buf, int slen,
     return d;
 }
 
+/*
+ * The vector encoders find the end of a zero run (the first byte that
+ * differs) or of a nzrun (the first byte that is equal) 16 or 32 bytes at
+ * a time.  Runs are maximal in all encoders, so the output is the same.
+ * They take word aligned buffers only; xbzrle_encode_buffer() passes
+ * anything else to the word at a time encoder.
+ */
+static inline bool xbzrle_aligned(uint8_t *old_buf, uint8_t *new_buf,
+                                  int slen)
+{
+    return !(((uintptr_t)old_buf | (uintptr_t)new_buf | slen) %
+             sizeof(long));
+}
+
+typedef int XbzrleScanFunc(const uint8_t *old_buf, const uint8_t *new_buf,
+                           int i, int slen, bool equal);
+
+static inline int xbzrle_scan_tail(const uint8_t *old_buf,
+                                   const uint8_t *new_buf,
+                                   int i, int slen, bool equal)
+{
+    while (i < slen && (old_buf[i] == new_buf[i]) == equal) {
+        i++;
+    }
+    return i;
+}
+
+static inline int __attribute__((always_inline))
+xbzrle_encode_runs(uint8_t *old_buf, uint8_t *new_buf, int slen,
+                   uint8_t *dst, int dlen, XbzrleScanFunc *scan)
+{
+    int d = 0, i = 0;
+    int start, zrun_len, nzrun_len;
+
+    while (i < slen) {
+        /* overflow */
+        if (d + 2 > dlen) {
+            return -1;
+        }
+
+        start = i;
+        i = scan(old_buf, new_buf, i, slen, true);
+        zrun_len = i - start;
+
+        /* buffer unchanged */
+        if (zrun_len == slen) {
+            return 0;
+        }
+
+        /* skip last zero run */
+        if (i == slen) {
+            return d;
+        }
+
+        d += uleb128_encode_small(dst + d, zrun_len);
+
+        /* overflow */
+        if (d + 2 > dlen) {
+            return -1;
+        }
+
+        start = i;
+        i = scan(old_buf, new_buf, i, slen, false);
+        nzrun_len = i - start;
+
+        d += uleb128_encode_small(dst + d, nzrun_len);
+        /* overflow */
+        if (d + nzrun_len > dlen) {
+            return -1;
+        }
+        memcpy(dst + d, new_buf + start, nzrun_len);
+        d += nzrun_len;
+    }
+
+    return d;
+}
+
+/* Built with target() attributes and chosen with __builtin_cpu_supports(),
+ * which CONFIG_AVX2_OPT guarantees, so that e.g. i386 builds use them too.
+ */
+#ifdef CONFIG_AVX2_OPT
+static inline int __attribute__((target("sse2"), always_inline))
+xbzrle_scan_sse2(const uint8_t *old_buf, const uint8_t *new_buf,
+                 int i, int slen, bool equal)
+{
+    __m128i a, b;
+    unsigned mask;
+
+    for (; i + 16 <= slen; i += 16) {
+        a = _mm_loadu_si128((const __m128i *)(old_buf + i));
+        b = _mm_loadu_si128((const __m128i *)(new_buf + i));
+        /* bits of the bytes that end the run */
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+        if (equal) {
+            mask = ~mask & 0xffff;
+        }
+        if (mask) {
+            return i + ctz32(mask);
+        }
+    }
+    return xbzrle_scan_tail(old_buf, new_buf, i, slen, equal);
+}
+
+static int __attribute__((target("sse2")))
+xbzrle_encode_buffer_sse2(uint8_t *old_buf, uint8_t *new_buf,
+                          int slen, uint8_t *dst, int dlen)
+{
+    g_assert(xbzrle_aligned(old_buf, new_buf, slen));
+    return xbzrle_encode_runs(old_buf, new_buf, slen, dst, dlen,
+                              xbzrle_scan_sse2);
+}
+
+static inline int __attribute__((target("avx2"), always_inline))
+xbzrle_scan_avx2(const uint8_t *old_buf, const uint8_t *new_buf,
+                 int i, int slen, bool equal)
+{
+    __m256i a, b;
+    uint32_t mask;
+
+    for (; i + 32 <= slen; i += 32) {
+        a = _mm256_loadu_si256((const __m256i *)(old_buf + i));
+        b = _mm256_loadu_si256((const __m256i *)(new_buf + i));
+        /* bits of the bytes that end the run */
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+        if (equal) {
+            mask = ~mask;
+        }
+        if (mask) {
+            return i + ctz32(mask);
+        }
+    }
+    return xbzrle_scan_tail(old_buf, new_buf, i, slen, equal);
+}
+
+static int __attribute__((target("avx2")))
+xbzrle_encode_buffer_avx2(uint8_t *old_buf, uint8_t *new_buf,
+                          int slen, uint8_t *dst, int dlen)
+{
+    g_assert(xbzrle_aligned(old_buf, new_buf, slen));
+    return xbzrle_encode_runs(old_buf, new_buf, slen, dst, dlen,
+                              xbzrle_scan_avx2);
+}
+#endif
+
+XbzrleEncodeFunc *xbzrle_encoder(XbzrleAccel accel)
+{
+    switch (accel) {
+    case XBZRLE_ACCEL_LONG:
+        return xbzrle_encode_buffer_long;
+#ifdef CONFIG_AVX2_OPT
+    case XBZRLE_ACCEL_SSE2:
+        if (__builtin_cpu_supports("sse2")) {
+            return xbzrle_encode_buffer_sse2;
+        }
+        break;
+    case XBZRLE_ACCEL_AVX2:
+        if (__builtin_cpu_supports("avx2")) {
+            return xbzrle_encode_buffer_avx2;
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+    return NULL;
+}
+
+static XbzrleEncodeFunc *xbzrle_encode_func;
+
+static void __attribute__((constructor)) init_xbzrle_encoder(void)
+{
+    int accel;
+
+#ifdef CONFIG_AVX2_OPT
+    /* constructors may run before the one that initializes the CPU model */
+    __builtin_cpu_init();
+#endif
+    for (accel = XBZRLE_ACCEL_MAX - 1; !xbzrle_encode_func; accel--) {
+        xbzrle_encode_func = xbzrle_encoder(accel);
+    }
+}
+
+int xbzrle_encode_buffer(uint8_t *old_buf, uint8_t *new_buf, int slen,
+                         uint8_t *dst, int dlen)
+{
+    if (!xbzrle_aligned(old_buf, new_buf, slen)) {
+        return xbzrle_encode_buffer_long(old_buf, new_buf, slen, dst, dlen);
+    }
+    return xbzrle_encode_func(old_buf, new_buf, slen, dst, dlen);
+}
+
 int xbzrle_decode_buffer(uint8_t *src, int slen, uint8_t *dst, int dlen)
 {
     int i = 0, d = 0;